@@ -0,0 +1,34 @@
+#include <fox/concurrent_inplace_free_list.hpp>
+#include <fox/inplace_free_list.hpp>
+
+#include "emplace_erase_benchmark.hpp"
+
+#include <benchmark/benchmark.h>
+#include <mutex>
+
+namespace
+{
+	using fox::benchmark_detail::message;
+
+	constexpr std::size_t capacity = 4096;
+
+	fox::concurrent_inplace_free_list<message, capacity> concurrent_pool;
+
+	std::mutex locked_pool_mutex;
+	fox::inplace_free_list<message, capacity> locked_pool;
+
+	void concurrent_emplace_erase(benchmark::State& state)
+	{
+		fox::benchmark_detail::emplace_erase(state,
+			[](const message& value) { return concurrent_pool.emplace(value); },
+			[](const message* ptr) { concurrent_pool.erase(ptr); });
+	}
+
+	void mutex_emplace_erase(benchmark::State& state)
+	{
+		fox::benchmark_detail::mutex_emplace_erase(state, locked_pool_mutex, locked_pool);
+	}
+}
+
+BENCHMARK(concurrent_emplace_erase)->ThreadRange(1, fox::benchmark_detail::max_threads)->UseRealTime();
+BENCHMARK(mutex_emplace_erase)->ThreadRange(1, fox::benchmark_detail::max_threads)->UseRealTime();
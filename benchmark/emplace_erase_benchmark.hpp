@@ -0,0 +1,49 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace fox::benchmark_detail
+{
+	inline constexpr std::size_t emplace_erase_batch = 16;
+
+	struct message
+	{
+		std::uint64_t id;
+		std::array<std::uint64_t, 3> payload;
+	};
+
+	// Every iteration emplaces a batch of messages and erases them again in the same order
+	template<class Emplace, class Erase>
+	void emplace_erase(benchmark::State& state, Emplace emplace, Erase erase)
+	{
+		std::array<message*, emplace_erase_batch> pointers;
+
+		for (auto _ : state)
+		{
+			for (std::size_t i{}; i < emplace_erase_batch; ++i)
+				pointers[i] = emplace(message{ i, {} });
+
+			for (std::size_t i{}; i < emplace_erase_batch; ++i)
+				erase(pointers[i]);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(emplace_erase_batch));
+	}
+
+	// Baseline for the concurrent lists, every emplace and erase takes the mutex
+	template<class List>
+	void mutex_emplace_erase(benchmark::State& state, std::mutex& mutex, List& list)
+	{
+		emplace_erase(state,
+			[&](const message& value) { std::scoped_lock lock(mutex); return list.emplace(value); },
+			[&](const message* ptr) { std::scoped_lock lock(mutex); list.erase(ptr); });
+	}
+
+	inline const int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
@@ -0,0 +1,94 @@
+#include <fox/fixed_block_resource.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	constexpr std::size_t block_size = 48;
+	constexpr std::size_t chunk_capacity = 256;
+
+	using fixed_block_resource = fox::pmr::fixed_block_resource<block_size, chunk_capacity>;
+	using aligned_fixed_block_resource = fox::pmr::fixed_block_resource<block_size, chunk_capacity, fox::aligned_chunk_lookup_policy>;
+
+	// Builds a list of state.range(0) nodes, then pops the front and pushes the back so nodes are recycled out of order
+	template<class Resource>
+	void list_churn(benchmark::State& state)
+	{
+		Resource resource;
+		std::pmr::list<std::int64_t> list(&resource);
+
+		for (std::int64_t i{}; i < state.range(0); ++i)
+			list.push_back(i);
+
+		std::int64_t i{};
+		for (auto _ : state)
+		{
+			list.pop_front();
+			list.push_back(i++);
+		}
+
+		benchmark::DoNotOptimize(list.back());
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// Inserts and erases random keys in a map holding about state.range(0) entries
+	template<class Resource>
+	void map_churn(benchmark::State& state)
+	{
+		Resource resource;
+		std::pmr::map<std::int64_t, std::int64_t> map(&resource);
+
+		const auto key_count = static_cast<std::uint32_t>(state.range(0) * 2);
+		std::mt19937 random_engine(5);
+
+		for (std::int64_t i{}; i < state.range(0); ++i)
+			map[random_engine() % key_count] = i;
+
+		for (auto _ : state)
+		{
+			map.erase(random_engine() % key_count);
+			map[random_engine() % key_count] = 0;
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// Fills an unordered_map and walks it, nodes of one chunk share cache lines
+	template<class Resource>
+	void unordered_map_fill_iterate(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			Resource resource;
+			std::pmr::unordered_map<std::int64_t, std::int64_t> map(&resource);
+
+			for (std::int64_t i{}; i < state.range(0); ++i)
+				map.emplace(i, i);
+
+			std::int64_t sum{};
+			for (const auto& [key, value] : map)
+				sum += value;
+
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+}
+
+BENCHMARK(list_churn<std::pmr::unsynchronized_pool_resource>)->Arg(1000)->Arg(100000);
+BENCHMARK(list_churn<fixed_block_resource>)->Arg(1000)->Arg(100000);
+BENCHMARK(list_churn<aligned_fixed_block_resource>)->Arg(1000)->Arg(100000);
+BENCHMARK(map_churn<std::pmr::unsynchronized_pool_resource>)->Arg(1000)->Arg(100000);
+BENCHMARK(map_churn<fixed_block_resource>)->Arg(1000)->Arg(100000);
+BENCHMARK(map_churn<aligned_fixed_block_resource>)->Arg(1000)->Arg(100000);
+BENCHMARK(unordered_map_fill_iterate<std::pmr::unsynchronized_pool_resource>)->Arg(1000)->Arg(100000);
+BENCHMARK(unordered_map_fill_iterate<fixed_block_resource>)->Arg(1000)->Arg(100000);
+BENCHMARK(unordered_map_fill_iterate<aligned_fixed_block_resource>)->Arg(1000)->Arg(100000);
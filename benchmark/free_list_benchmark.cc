@@ -0,0 +1,370 @@
+#include <fox/free_list.hpp>
+#include <fox/free_list_parallel.hpp>
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <barrier>
+#include <condition_variable>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	constexpr std::size_t chunk_capacity = 64;
+	using free_list = fox::free_list<std::int64_t, chunk_capacity>;
+	using aligned_free_list = fox::free_list<std::int64_t, chunk_capacity, std::allocator<std::int64_t>,
+		fox::lifo_allocation_policy, fox::packed_layout_policy, fox::aligned_chunk_lookup_policy>;
+	using remote_free_list = fox::free_list<std::int64_t, chunk_capacity, std::allocator<std::int64_t>,
+		fox::lifo_allocation_policy, fox::packed_layout_policy, fox::aligned_chunk_lookup_policy, fox::packed_index_policy<>, fox::remote_free_policy>;
+
+	// Every full chunk is passed over when looking for room, only the chunks appended while timing have any
+	void emplace_into_full_pool(benchmark::State& state)
+	{
+		constexpr std::size_t batch = 1024;
+
+		free_list list;
+		std::vector<std::int64_t*> pointers;
+		list.emplace_n(static_cast<std::size_t>(state.range(0)) * chunk_capacity, std::back_inserter(pointers), 0);
+
+		pointers.clear();
+		pointers.reserve(batch);
+
+		for (auto _ : state)
+		{
+			for (std::size_t i{}; i < batch; ++i)
+				pointers.push_back(list.emplace(static_cast<std::int64_t>(i)));
+
+			state.PauseTiming();
+			list.erase_n(pointers);
+			pointers.clear();
+			state.ResumeTiming();
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batch));
+	}
+
+	// Erases from random chunks of the pool, every erase looks up the chunk owning the pointer
+	template<class List>
+	void erase_from_pool(benchmark::State& state)
+	{
+		List list;
+		std::vector<std::int64_t*> pointers;
+		list.emplace_n(static_cast<std::size_t>(state.range(0)) * chunk_capacity, std::back_inserter(pointers), 0);
+
+		std::mt19937 random_engine(42);
+		std::shuffle(std::begin(pointers), std::end(pointers), random_engine);
+
+		std::size_t next{};
+		for (auto _ : state)
+		{
+			list.erase(pointers[next]);
+			pointers[next] = list.emplace(0);
+			next = (next + 1) % std::size(pointers);
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// Size oscillates around a chunk boundary, range(0) is the number of retained empty chunks
+	void oscillate_at_chunk_boundary(benchmark::State& state)
+	{
+		free_list list;
+		std::vector<std::int64_t*> pointers;
+		list.emplace_n(100 * chunk_capacity, std::back_inserter(pointers), 0);
+		list.set_empty_chunk_retention(static_cast<std::size_t>(state.range(0)));
+
+		for (auto _ : state)
+		{
+			list.erase(list.emplace(0));
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// 1000 chunks with range(0) percent of the slots live, chosen at random
+	void fill_percent(free_list& list, std::int64_t percent)
+	{
+		std::vector<std::int64_t*> pointers;
+		list.emplace_n(1000 * chunk_capacity, std::back_inserter(pointers), 1);
+
+		std::mt19937 random_engine(42);
+		std::shuffle(std::begin(pointers), std::end(pointers), random_engine);
+
+		const std::size_t to_erase = std::size(pointers) - std::size(pointers) * static_cast<std::size_t>(percent) / 100;
+		list.erase_n(std::span(pointers).first(to_erase));
+	}
+
+	void chunk_free_mask_loop(benchmark::State& state)
+	{
+		free_list list;
+		fill_percent(list, state.range(0));
+
+		for (auto _ : state)
+		{
+			std::int64_t sum{};
+			for (auto it = list.chunks_begin(); it != list.chunks_end(); ++it)
+			{
+				auto mask = it->free_mask();
+				for (std::size_t i{}; i < std::size(mask); ++i)
+				{
+					if (!mask.test(i))
+						sum += *(*it)[i];
+				}
+			}
+
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(list.size()));
+	}
+
+	void live_iterator_loop(benchmark::State& state)
+	{
+		free_list list;
+		fill_percent(list, state.range(0));
+
+		for (auto _ : state)
+		{
+			std::int64_t sum = std::accumulate(std::begin(list), std::end(list), std::int64_t{});
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(list.size()));
+	}
+
+	void for_each_live(benchmark::State& state)
+	{
+		free_list list;
+		fill_percent(list, state.range(0));
+
+		for (auto _ : state)
+		{
+			std::int64_t sum{};
+			list.for_each_live([&](std::int64_t value) { sum += value; });
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(list.size()));
+	}
+
+	// Updates every value of range(0) full chunks, chunks are the units of parallel work.
+	// Standard execution policies don't take a thread count, see partitioned_sum for scaling over threads.
+	template<auto Policy>
+	void parallel_update(benchmark::State& state)
+	{
+		free_list list;
+		std::vector<std::int64_t*> pointers;
+		list.emplace_n(static_cast<std::size_t>(state.range(0)) * chunk_capacity, std::back_inserter(pointers), 1);
+
+		for (auto _ : state)
+		{
+			fox::parallel_for_each(*Policy, list, [](std::int64_t& value) { value = value * 3 + 1; });
+			benchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(list.size()));
+	}
+
+	template<auto Policy>
+	void parallel_sum(benchmark::State& state)
+	{
+		free_list list;
+		std::vector<std::int64_t*> pointers;
+		list.emplace_n(static_cast<std::size_t>(state.range(0)) * chunk_capacity, std::back_inserter(pointers), 1);
+
+		for (auto _ : state)
+		{
+			auto sum = fox::parallel_transform_reduce(*Policy, list, std::int64_t{}, std::plus<>{}, [](std::int64_t value) { return value; });
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(list.size()));
+	}
+
+	// Sums range(0) full chunks split into contiguous chunk ranges over a pool of range(1) threads, the timed
+	// thread sums the first range. Measures how chunk-granular parallel reads scale with the thread count.
+	void partitioned_sum(benchmark::State& state)
+	{
+		free_list list;
+		std::vector<std::int64_t*> pointers;
+		list.emplace_n(static_cast<std::size_t>(state.range(0)) * chunk_capacity, std::back_inserter(pointers), 1);
+
+		const auto thread_count = static_cast<std::size_t>(state.range(1));
+		const auto chunk_count = static_cast<std::size_t>(std::distance(list.chunks_cbegin(), list.chunks_cend()));
+
+		struct alignas(64) partial_sum
+		{
+			std::int64_t value;
+		};
+
+		std::vector<partial_sum> sums(thread_count);
+		bool done = false;
+
+		const auto sum_range = [&](std::size_t t)
+		{
+			const auto first = std::next(list.chunks_cbegin(), static_cast<std::ptrdiff_t>(chunk_count * t / thread_count));
+			const auto last = std::next(list.chunks_cbegin(), static_cast<std::ptrdiff_t>(chunk_count * (t + 1) / thread_count));
+
+			std::int64_t sum{};
+			for (auto it = first; it != last; ++it)
+				it->for_each_live([&](std::int64_t value) { sum += value; });
+
+			sums[t].value = sum;
+		};
+
+		std::barrier start(static_cast<std::ptrdiff_t>(thread_count));
+		std::barrier finish(static_cast<std::ptrdiff_t>(thread_count));
+
+		std::vector<std::thread> pool;
+		for (std::size_t t = 1; t < thread_count; ++t)
+		{
+			pool.emplace_back([&, t]()
+			{
+				for (;;)
+				{
+					start.arrive_and_wait();
+					if (done)
+						return;
+
+					sum_range(t);
+					finish.arrive_and_wait();
+				}
+			});
+		}
+
+		for (auto _ : state)
+		{
+			start.arrive_and_wait();
+			sum_range(0);
+			finish.arrive_and_wait();
+
+			std::int64_t sum{};
+			for (const auto& s : sums)
+				sum += s.value;
+
+			benchmark::DoNotOptimize(sum);
+		}
+
+		done = true;
+		start.arrive_and_wait();
+
+		for (auto& thread : pool)
+			thread.join();
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(list.size()));
+	}
+
+	// Timed thread emplaces batches handed to state.range(0) consumer threads which erase them, either with
+	// remote_erase or by locking the list the producer also locks around emplace
+	template<bool Remote>
+	void producer_consumer(benchmark::State& state)
+	{
+		constexpr std::size_t batch_size = 256;
+		constexpr std::size_t max_queued = 16;
+
+		std::conditional_t<Remote, remote_free_list, free_list> list;
+		std::mutex list_mutex;
+
+		std::mutex queue_mutex;
+		std::condition_variable queue_changed;
+		std::vector<std::vector<std::int64_t*>> queue;
+		bool done = false;
+
+		std::vector<std::thread> consumers;
+		for (std::int64_t t{}; t < state.range(0); ++t)
+		{
+			consumers.emplace_back([&]()
+			{
+				for (;;)
+				{
+					std::vector<std::int64_t*> batch;
+					{
+						std::unique_lock lock(queue_mutex);
+						queue_changed.wait(lock, [&]() { return done || !std::empty(queue); });
+						if (std::empty(queue))
+							return;
+
+						batch = std::move(queue.back());
+						queue.pop_back();
+					}
+					queue_changed.notify_all();
+
+					for (auto ptr : batch)
+					{
+						if constexpr (Remote)
+						{
+							list.remote_erase(ptr);
+						}
+						else
+						{
+							std::scoped_lock lock(list_mutex);
+							list.erase(ptr);
+						}
+					}
+				}
+			});
+		}
+
+		for (auto _ : state)
+		{
+			std::vector<std::int64_t*> batch;
+			batch.reserve(batch_size);
+
+			for (std::size_t i{}; i < batch_size; ++i)
+			{
+				if constexpr (Remote)
+				{
+					batch.push_back(list.emplace(static_cast<std::int64_t>(i)));
+				}
+				else
+				{
+					std::scoped_lock lock(list_mutex);
+					batch.push_back(list.emplace(static_cast<std::int64_t>(i)));
+				}
+			}
+
+			{
+				std::unique_lock lock(queue_mutex);
+				queue_changed.wait(lock, [&]() { return std::size(queue) < max_queued; });
+				queue.push_back(std::move(batch));
+			}
+			queue_changed.notify_all();
+		}
+
+		{
+			std::scoped_lock lock(queue_mutex);
+			done = true;
+		}
+		queue_changed.notify_all();
+
+		for (auto& t : consumers)
+			t.join();
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batch_size));
+	}
+}
+
+BENCHMARK(emplace_into_full_pool)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(erase_from_pool<free_list>)->Arg(100)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK(erase_from_pool<aligned_free_list>)->Arg(100)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK(oscillate_at_chunk_boundary)->Arg(0)->Arg(1);
+BENCHMARK(chunk_free_mask_loop)->Arg(5)->Arg(50)->Arg(95);
+BENCHMARK(live_iterator_loop)->Arg(5)->Arg(50)->Arg(95);
+BENCHMARK(for_each_live)->Arg(5)->Arg(50)->Arg(95);
+BENCHMARK(parallel_update<&std::execution::seq>)->Arg(1000)->Arg(100000)->UseRealTime();
+BENCHMARK(parallel_update<&std::execution::par>)->Arg(1000)->Arg(100000)->UseRealTime();
+BENCHMARK(parallel_sum<&std::execution::seq>)->Arg(1000)->Arg(100000)->UseRealTime();
+BENCHMARK(parallel_sum<&std::execution::par>)->Arg(1000)->Arg(100000)->UseRealTime();
+BENCHMARK(partitioned_sum)->Apply([](benchmark::internal::Benchmark* b)
+	{
+		for (std::int64_t threads = 1; threads <= std::max<std::int64_t>(std::thread::hardware_concurrency(), 1); ++threads)
+			b->Args({ 100000, threads });
+	})->UseRealTime();
+BENCHMARK(producer_consumer<false>)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+BENCHMARK(producer_consumer<true>)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
@@ -0,0 +1,151 @@
+#include <fox/inplace_free_list.hpp>
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr std::size_t capacity = 4096;
+	using inplace_free_list = fox::inplace_free_list<std::int64_t, capacity>;
+
+	struct order
+	{
+		std::int64_t id;
+		double price;
+		std::int32_t quantity;
+	};
+
+	using order_free_list = fox::inplace_free_list<order, capacity>;
+
+	// Fills the list and erases random slots until percent of the capacity is left
+	template<class List, class Make>
+	void fill_percent(List& list, std::int64_t percent, Make make)
+	{
+		std::vector<typename List::pointer> pointers;
+		for (std::int64_t i{}; i < static_cast<std::int64_t>(capacity); ++i)
+			pointers.push_back(list.emplace(make(i)));
+
+		std::mt19937 random_engine(42);
+		std::shuffle(std::begin(pointers), std::end(pointers), random_engine);
+
+		const std::size_t to_erase = capacity - capacity * static_cast<std::size_t>(percent) / 100;
+		for (std::size_t i{}; i < to_erase; ++i)
+			list.erase(pointers[i]);
+	}
+
+	void fill_percent(inplace_free_list& list, std::int64_t percent)
+	{
+		fill_percent(list, percent, [](std::int64_t i) { return i; });
+	}
+
+	void fill_percent(order_free_list& list, std::int64_t percent)
+	{
+		fill_percent(list, percent, [](std::int64_t i) { return order{ i, static_cast<double>(i * 2654435761 % 100), 1 }; });
+	}
+
+	void free_mask_loop(benchmark::State& state)
+	{
+		inplace_free_list list;
+		fill_percent(list, state.range(0));
+
+		for (auto _ : state)
+		{
+			std::int64_t sum{};
+			auto mask = list.free_mask();
+			for (std::size_t i{}; i < std::size(mask); ++i)
+			{
+				if (!mask.test(i))
+					sum += *list[i];
+			}
+
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(list.size()));
+	}
+
+	void iterator_loop(benchmark::State& state)
+	{
+		inplace_free_list list;
+		fill_percent(list, state.range(0));
+
+		for (auto _ : state)
+		{
+			std::int64_t sum = std::accumulate(std::begin(list), std::end(list), std::int64_t{});
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(list.size()));
+	}
+
+	void for_each_live(benchmark::State& state)
+	{
+		inplace_free_list list;
+		fill_percent(list, state.range(0));
+
+		for (auto _ : state)
+		{
+			std::int64_t sum{};
+			list.for_each_live([&](std::int64_t v) { sum += v; });
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(list.size()));
+	}
+
+	constexpr fox::greater_than_value<double> above{ 50.0 };
+
+	void scalar_count(benchmark::State& state)
+	{
+		order_free_list list;
+		fill_percent(list, state.range(0));
+
+		for (auto _ : state)
+		{
+			std::size_t count{};
+			list.for_each_live([&](const order& o) { count += above(o.price); });
+			benchmark::DoNotOptimize(count);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(list.size()));
+	}
+
+	void count_if(benchmark::State& state)
+	{
+		order_free_list list;
+		fill_percent(list, state.range(0));
+
+		for (auto _ : state)
+		{
+			std::size_t count = list.count_if(above, &order::price);
+			benchmark::DoNotOptimize(count);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(list.size()));
+	}
+
+	void count_if_lambda(benchmark::State& state)
+	{
+		order_free_list list;
+		fill_percent(list, state.range(0));
+
+		for (auto _ : state)
+		{
+			std::size_t count = list.count_if([](double price) { return price > 50.0; }, &order::price);
+			benchmark::DoNotOptimize(count);
+		}
+
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(list.size()));
+	}
+}
+
+BENCHMARK(free_mask_loop)->Arg(5)->Arg(50)->Arg(95);
+BENCHMARK(iterator_loop)->Arg(5)->Arg(50)->Arg(95);
+BENCHMARK(for_each_live)->Arg(5)->Arg(50)->Arg(95);
+BENCHMARK(scalar_count)->Arg(5)->Arg(50)->Arg(95);
+BENCHMARK(count_if)->Arg(5)->Arg(50)->Arg(95);
+BENCHMARK(count_if_lambda)->Arg(5)->Arg(50)->Arg(95);
@@ -0,0 +1,36 @@
+#include <fox/thread_caching_free_list.hpp>
+#include <fox/free_list.hpp>
+
+#include "emplace_erase_benchmark.hpp"
+
+#include <benchmark/benchmark.h>
+#include <mutex>
+
+namespace
+{
+	using fox::benchmark_detail::message;
+
+	constexpr std::size_t chunk_capacity = 256;
+
+	fox::thread_caching_free_list<message, chunk_capacity> caching_pool;
+
+	std::mutex locked_pool_mutex;
+	fox::free_list<message, chunk_capacity> locked_pool;
+
+	void magazine_emplace_erase(benchmark::State& state)
+	{
+		decltype(caching_pool)::magazine magazine(caching_pool);
+
+		fox::benchmark_detail::emplace_erase(state,
+			[&](const message& value) { return magazine.emplace(value); },
+			[&](const message* ptr) { magazine.erase(ptr); });
+	}
+
+	void mutex_emplace_erase(benchmark::State& state)
+	{
+		fox::benchmark_detail::mutex_emplace_erase(state, locked_pool_mutex, locked_pool);
+	}
+}
+
+BENCHMARK(magazine_emplace_erase)->ThreadRange(1, fox::benchmark_detail::max_threads)->UseRealTime();
+BENCHMARK(mutex_emplace_erase)->ThreadRange(1, fox::benchmark_detail::max_threads)->UseRealTime();
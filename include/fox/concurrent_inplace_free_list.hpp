@@ -0,0 +1,240 @@
+#pragma once
+
+#include <type_traits>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <utility>
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+
+namespace fox
+{
+	// Fixed capacity free list which can be used from multiple threads without locking.
+	// emplace, insert and erase may be called concurrently, other members require exclusive access.
+	// size, empty and full are the exception, they may be called at any time but are only a snapshot while
+	// other threads are inserting or erasing.
+	template<class T, std::size_t Capacity>
+	class concurrent_inplace_free_list
+	{
+		using offset_type = std::conditional_t<
+			(Capacity < std::numeric_limits<std::uint16_t>::max()),
+			std::uint16_t,
+			std::uint32_t
+		>;
+
+		static constexpr offset_type offset_type_npos = std::numeric_limits<offset_type>::max();
+		static_assert(Capacity < offset_type_npos);
+
+		// Head of the free chain packs the first free offset in the low bits and a version counter in the high bits.
+		// Version is advanced on every successful update so a stale head can't be swapped back in (ABA).
+		using head_type = std::uint64_t;
+		static constexpr std::size_t head_offset_bits = 32;
+		static constexpr head_type head_offset_mask = (head_type{ 1 } << head_offset_bits) - 1;
+		static_assert(std::atomic<head_type>::is_always_lock_free);
+
+		std::atomic<head_type> head_;
+		std::atomic<std::size_t> high_water_mark_;
+
+		// Counted relaxed, exact once concurrent emplaces and erases have been synchronized with
+		std::atomic<std::size_t> size_;
+
+		// Links are kept next to the storage rather than inside the slots, a thread losing the race for a slot
+		// may still read its link while the winner is constructing a value in it.
+		std::array<std::atomic<offset_type>, Capacity> next_;
+		alignas(alignof(T)) std::array<std::uint8_t, Capacity * sizeof(T)> storage_;
+
+	public:
+		using value_type = T;
+		using reference = T&;
+		using const_reference = const T&;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+	public:
+		concurrent_inplace_free_list() noexcept
+			: head_(offset_type_npos), high_water_mark_(0), size_(0) {}
+
+		concurrent_inplace_free_list(const concurrent_inplace_free_list&) = delete;
+		concurrent_inplace_free_list(concurrent_inplace_free_list&&) = delete;
+		concurrent_inplace_free_list& operator=(const concurrent_inplace_free_list&) = delete;
+		concurrent_inplace_free_list& operator=(concurrent_inplace_free_list&&) = delete;
+
+		~concurrent_inplace_free_list()
+		{
+			if constexpr (!std::is_trivially_destructible_v<T>)
+			{
+				auto mask = free_mask();
+				for (std::size_t i{}; i < std::size(mask); ++i)
+				{
+					if (mask.test(i) == false)
+						std::destroy_at(data() + i);
+				}
+			}
+		}
+
+	public:
+		[[nodiscard]] static constexpr size_type capacity() noexcept
+		{
+			return Capacity;
+		}
+
+		// Approximate while other threads are inserting or erasing
+		[[nodiscard]] size_type size() const noexcept
+		{
+			return size_.load(std::memory_order_relaxed);
+		}
+
+		// Approximate while other threads are inserting or erasing
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		// Approximate while other threads are inserting or erasing
+		[[nodiscard]] bool full() const noexcept
+		{
+			return size() == Capacity;
+		}
+
+		// Requires exclusive access
+		[[nodiscard]] std::bitset<Capacity> free_mask() const noexcept
+		{
+			std::bitset<Capacity> out;
+
+			for (std::size_t i = std::min(high_water_mark_.load(std::memory_order_acquire), Capacity); i < Capacity; ++i)
+				out.set(i);
+
+			for (head_type i = head_.load(std::memory_order_acquire) & head_offset_mask; i != offset_type_npos; i = next_[i].load(std::memory_order_relaxed))
+				out.set(static_cast<std::size_t>(i));
+
+			return out;
+		}
+
+	public:
+		template<class... Args>
+		[[nodiscard]] T* emplace(Args&&... args) requires (std::constructible_from<T, Args...>)
+		{
+			const offset_type idx = acquire_slot();
+			if (idx == offset_type_npos)
+				return nullptr;
+
+			T* out = data() + idx;
+
+			try
+			{
+				std::construct_at(out, std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				release_slot(idx);
+				std::rethrow_exception(std::current_exception());
+			}
+
+			return out;
+		}
+
+		[[nodiscard]] T* insert(const T& value) requires (std::is_copy_constructible_v<T>)
+		{
+			return emplace(value);
+		}
+
+		[[nodiscard]] T* insert(T&& value) requires (std::is_move_constructible_v<T>)
+		{
+			return emplace(std::forward<T&&>(value));
+		}
+
+		void erase(const T* ptr) noexcept
+		{
+			assert_own(ptr);
+
+			std::destroy_at(const_cast<T*>(ptr));
+			release_slot(static_cast<offset_type>(as_index(ptr)));
+		}
+
+	public:
+		[[nodiscard]] T* data() noexcept
+		{
+			return reinterpret_cast<T*>(std::data(storage_));
+		}
+
+		[[nodiscard]] const T* data() const noexcept
+		{
+			return reinterpret_cast<const T*>(std::data(storage_));
+		}
+
+		[[nodiscard]] bool owns(const T* ptr) const noexcept
+		{
+			return
+				std::data(storage_) <= reinterpret_cast<const std::uint8_t*>(ptr) &&
+				reinterpret_cast<const std::uint8_t*>(ptr) < std::data(storage_) + std::size(storage_);
+		}
+
+		[[nodiscard]] size_type as_index(const T* ptr) const noexcept
+		{
+			assert_own(ptr);
+
+			return static_cast<std::size_t>(ptr - data());
+		}
+
+	private:
+		void assert_own([[maybe_unused]] const T* ptr) const
+		{
+			assert(this->owns(ptr) == true && "concurrent_inplace_free_list<T> doesn't own this pointer.");
+		}
+
+		[[nodiscard]] static head_type make_head(head_type previous, offset_type offset) noexcept
+		{
+			const head_type version = (previous >> head_offset_bits) + 1;
+			return (version << head_offset_bits) | static_cast<head_type>(offset);
+		}
+
+		// Pops the free chain, falls back to never used slots, returns offset_type_npos when full
+		[[nodiscard]] offset_type acquire_slot() noexcept
+		{
+			head_type head = head_.load(std::memory_order_acquire);
+			while ((head & head_offset_mask) != offset_type_npos)
+			{
+				const auto idx = static_cast<offset_type>(head & head_offset_mask);
+				const offset_type next = next_[idx].load(std::memory_order_relaxed);
+
+				if (head_.compare_exchange_weak(head, make_head(head, next), std::memory_order_acquire, std::memory_order_acquire))
+				{
+					size_.fetch_add(1, std::memory_order_relaxed);
+					return idx;
+				}
+			}
+
+			std::size_t mark = high_water_mark_.load(std::memory_order_relaxed);
+			while (mark < Capacity)
+			{
+				if (high_water_mark_.compare_exchange_weak(mark, mark + 1, std::memory_order_relaxed))
+				{
+					size_.fetch_add(1, std::memory_order_relaxed);
+					return static_cast<offset_type>(mark);
+				}
+			}
+
+			return offset_type_npos;
+		}
+
+		// Pushes a slot whose value was already destroyed onto the free chain
+		void release_slot(offset_type idx) noexcept
+		{
+			size_.fetch_sub(1, std::memory_order_relaxed);
+
+			head_type head = head_.load(std::memory_order_relaxed);
+			do
+			{
+				next_[idx].store(static_cast<offset_type>(head & head_offset_mask), std::memory_order_relaxed);
+			}
+			while (!head_.compare_exchange_weak(head, make_head(head, idx), std::memory_order_release, std::memory_order_relaxed));
+		}
+	};
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <fox/free_list.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+namespace fox
+{
+	namespace pmr
+	{
+		// Memory resource handing out blocks of BlockSize bytes from the chunks of a free_list, so node containers get
+		// their nodes packed ChunkCapacity to a chunk. Chunks are allocated from the upstream resource, requests larger
+		// than a block or more aligned than block_alignment() are passed to it. Like std::pmr::unsynchronized_pool_resource
+		// it isn't thread safe, unlike it release() only frees the chunks, requests passed upstream aren't tracked.
+		template<std::size_t BlockSize, std::size_t ChunkCapacity, class ChunkLookupPolicy = indexed_chunk_lookup_policy>
+		class fixed_block_resource : public std::pmr::memory_resource
+		{
+			static_assert(BlockSize != 0, "fixed_block_resource block size can't be zero.");
+
+			// Largest power of two dividing BlockSize, capped so blocks aren't padded beyond what any type needs
+			static constexpr std::size_t alignment = std::min(BlockSize & (~BlockSize + 1), alignof(std::max_align_t));
+
+			// Storage for one block, emplacing it doesn't touch the bytes
+			struct block
+			{
+				alignas(alignment) std::byte storage[BlockSize];
+
+				block() noexcept {}
+			};
+
+			free_list<block, ChunkCapacity, lifo_allocation_policy, packed_layout_policy, ChunkLookupPolicy> blocks_;
+
+		public:
+			fixed_block_resource()
+				: fixed_block_resource(std::pmr::get_default_resource()) {}
+
+			explicit fixed_block_resource(std::pmr::memory_resource* upstream)
+				: blocks_(std::pmr::polymorphic_allocator<block>(upstream)) {}
+
+			fixed_block_resource(const fixed_block_resource&) = delete;
+			fixed_block_resource& operator=(const fixed_block_resource&) = delete;
+
+			~fixed_block_resource() override = default;
+
+		public:
+			[[nodiscard]] std::pmr::memory_resource* upstream_resource() const
+			{
+				return blocks_.get_allocator().resource();
+			}
+
+			[[nodiscard]] static constexpr std::size_t block_size() noexcept
+			{
+				return BlockSize;
+			}
+
+			[[nodiscard]] static constexpr std::size_t block_alignment() noexcept
+			{
+				return alignment;
+			}
+
+			[[nodiscard]] static constexpr std::size_t chunk_capacity() noexcept
+			{
+				return ChunkCapacity;
+			}
+
+			// Blocks handed out and chunks holding them, requests passed upstream aren't counted
+			[[nodiscard]] free_list_statistics statistics() const noexcept
+			{
+				return blocks_.statistics();
+			}
+
+			// Keeps up to count empty chunks allocated, see free_list::set_empty_chunk_retention
+			void set_empty_chunk_retention(std::size_t count) noexcept
+			{
+				blocks_.set_empty_chunk_retention(count);
+			}
+
+			// Returns every chunk and the list's bookkeeping to the upstream resource, blocks handed out become dangling
+			void release()
+			{
+				decltype(blocks_) released(blocks_.get_allocator());
+				released.set_empty_chunk_retention(blocks_.empty_chunk_retention());
+				blocks_ = std::move(released);
+			}
+
+		protected:
+			void* do_allocate(std::size_t bytes, std::size_t align) override
+			{
+				if (bytes > BlockSize || align > alignment)
+					return upstream_resource()->allocate(bytes, align);
+
+				return blocks_.emplace();
+			}
+
+			void do_deallocate(void* ptr, std::size_t bytes, std::size_t align) override
+			{
+				if (bytes > BlockSize || align > alignment)
+					return upstream_resource()->deallocate(ptr, bytes, align);
+
+				blocks_.erase(static_cast<const block*>(ptr));
+			}
+
+			[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+			{
+				return this == std::addressof(other);
+			}
+		};
+	}
+}
@@ -5,20 +5,111 @@
 
 #include <type_traits>
 #include <memory_resource>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <functional>
+#include <ranges>
+#include <bit>
 #include <set>
+#include <span>
+#include <stdexcept>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <utility>
+#include <vector>
 
 namespace fox
 {
-	template<class T, std::size_t ChunkCapacity, class Allocator = std::allocator<T>>
+	// Chunk owning a pointer is found by searching an address ordered index of the chunks
+	struct indexed_chunk_lookup_policy {};
+
+	// Chunks are allocated at an address aligned to their size rounded up to a power of two and store their own index,
+	// the chunk owning a pointer is found by masking off the low bits of the pointer.
+	// Only the chunk's size is requested, but the allocator may not reuse the padding in front of an aligned block,
+	// so ChunkCapacity is best picked to make a chunk just fit a power of two.
+	// Trades that padding for constant time erase, holds_value, as_index and owning_chunk.
+	struct aligned_chunk_lookup_policy
+	{
+		// Largest chunk size rounded up to a power of two, larger chunks need a smaller ChunkCapacity
+		static constexpr std::size_t max_chunk_alignment = std::size_t{ 1 } << 16;
+	};
+
+	// Indices are Index values holding the chunk number above SlotBits bits of slot position,
+	// SlotBits of 0 takes the fewest bits able to hold every slot position of a chunk
+	template<std::unsigned_integral Index = std::size_t, std::size_t SlotBits = 0>
+	struct packed_index_policy
+	{
+		using index_type = Index;
+		static constexpr std::size_t slot_bits = SlotBits;
+	};
+
+	// Values are only erased by the thread owning the list
+	struct local_free_policy {};
+
+	// Every chunk also has a lock-free list of values erased from other threads through remote_erase. Values on it are
+	// destroyed by the owning thread on its next emplace, so erasing from another thread never blocks the owner.
+	// Requires aligned_chunk_lookup_policy, a remote thread can't search the chunk index while the owner changes it.
+	struct remote_free_policy {};
+
+	// Occupancy of a free_list, every field is kept up to date so reading them is constant time
+	struct free_list_statistics
+	{
+		std::size_t size;
+		std::size_t capacity;
+		std::size_t chunk_count;
+		std::size_t empty_chunk_count;
+	};
+
+	// Gives the parallel algorithms of fox/free_list_parallel.hpp access to the chunks of a free_list
+	struct free_list_parallel_access;
+
+	// AllocationPolicy and LayoutPolicy are passed to every chunk
+	template<class T, std::size_t ChunkCapacity, class Allocator = std::allocator<T>, class AllocationPolicy = lifo_allocation_policy, class LayoutPolicy = packed_layout_policy, class ChunkLookupPolicy = indexed_chunk_lookup_policy, class IndexPolicy = packed_index_policy<>, class RemoteFreePolicy = local_free_policy>
 	class free_list
 	{
-		template<class, std::size_t, class>
+		template<class, std::size_t, class, class, class, class, class, class>
 		friend class free_list;
 
+		friend struct free_list_parallel_access;
+
+		static_assert(
+			std::is_same_v<ChunkLookupPolicy, indexed_chunk_lookup_policy> ||
+			std::is_same_v<ChunkLookupPolicy, aligned_chunk_lookup_policy>,
+			"free_list<T> unknown chunk lookup policy."
+		);
+
+		static_assert(
+			std::is_same_v<RemoteFreePolicy, local_free_policy> ||
+			std::is_same_v<RemoteFreePolicy, remote_free_policy>,
+			"free_list<T> unknown remote free policy."
+		);
+
+		static constexpr bool aligned_chunks = std::is_same_v<ChunkLookupPolicy, aligned_chunk_lookup_policy>;
+		static constexpr bool remote_free = std::is_same_v<RemoteFreePolicy, remote_free_policy>;
+
+		static_assert(!remote_free || aligned_chunks, "free_list<T> remote_free_policy requires aligned_chunk_lookup_policy.");
+
+		static constexpr std::size_t index_bits = std::numeric_limits<typename IndexPolicy::index_type>::digits;
+		static constexpr std::size_t slot_bits = IndexPolicy::slot_bits != 0 ? IndexPolicy::slot_bits : static_cast<std::size_t>(std::bit_width(ChunkCapacity - 1));
+		static constexpr std::size_t chunk_bits = index_bits - slot_bits;
+
+		static_assert(slot_bits < index_bits, "free_list<T> index has no bits left for the chunk number.");
+		static_assert(((ChunkCapacity - 1) >> slot_bits) == 0, "free_list<T> index slot bits can't hold every slot position.");
+
 	public:
 		using value_type = T;
-		using chunk_type = inplace_free_list<T, ChunkCapacity>;
+		using chunk_type = inplace_free_list<T, ChunkCapacity, AllocationPolicy, void, LayoutPolicy>;
 		using allocator_type = Allocator;
+		using allocation_policy = AllocationPolicy;
+		using layout_policy = LayoutPolicy;
+		using chunk_lookup_policy = ChunkLookupPolicy;
+		using index_policy = IndexPolicy;
+		using index_type = typename IndexPolicy::index_type;
 		using size_type = std::size_t;
 		using difference_type = std::ptrdiff_t;
 		using reference = T&;
@@ -27,49 +118,461 @@ namespace fox
 		using const_pointer = const T*;
 
 	private:
-		using chunk_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<chunk_type>;
+		// Forward iterator over live elements of every chunk, empty chunks are skipped without visiting their
+		// occupancy and within a chunk the chunk's own iterator skips empty slots
+		template<class U>
+		class iterator_implementation
+		{
+			template<class>
+			friend class iterator_implementation;
+
+			using list_pointer = std::conditional_t<std::is_const_v<U>, const free_list*, free_list*>;
+			using chunk_iterator = std::conditional_t<std::is_const_v<U>, typename chunk_type::const_iterator, typename chunk_type::iterator>;
+
+			// Current chunk and position within it, a value initialized chunk iterator compares equal to the end of any chunk
+			list_pointer list_ = nullptr;
+			size_type chunk_ = 0;
+			chunk_iterator current_ = {};
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using iterator_concept = std::forward_iterator_tag;
+			using difference_type = std::ptrdiff_t;
+			using value_type = std::remove_const_t<U>;
+			using reference = U&;
+			using pointer = U*;
+
+		public:
+			iterator_implementation() = default;
+
+			iterator_implementation(list_pointer list, size_type chunk) noexcept
+				: list_(list), chunk_(chunk)
+			{
+				skip_empty_chunks();
+			}
+
+			template<class V>
+			iterator_implementation(const iterator_implementation<V>& other) noexcept
+				requires(std::is_const_v<U> && !std::is_const_v<V>)
+				: list_(other.list_), chunk_(other.chunk_), current_(other.current_) {}
+
+		public:
+			[[nodiscard]] reference operator*() const noexcept
+			{
+				return *current_;
+			}
+
+			[[nodiscard]] pointer operator->() const noexcept
+			{
+				return std::addressof(*current_);
+			}
+
+			iterator_implementation& operator++() noexcept
+			{
+				if (++current_ == chunk_iterator{})
+				{
+					++chunk_;
+					skip_empty_chunks();
+				}
+
+				return *this;
+			}
+
+			[[nodiscard]] iterator_implementation operator++(int) noexcept
+			{
+				auto it = *this;
+				++(*this);
+				return it;
+			}
+
+			[[nodiscard]] friend bool operator==(const iterator_implementation& lhs, const iterator_implementation& rhs) noexcept
+			{
+				return lhs.chunk_ == rhs.chunk_ && lhs.current_ == rhs.current_;
+			}
+
+		private:
+			void skip_empty_chunks() noexcept
+			{
+				while (chunk_ != std::size(list_->chunks_) && list_->chunks_[chunk_].empty())
+					++chunk_;
+
+				current_ = chunk_ != std::size(list_->chunks_) ? std::begin(list_->chunks_[chunk_]) : chunk_iterator{};
+			}
+		};
+
+	public:
+		using iterator = iterator_implementation<T>;
+		using const_iterator = iterator_implementation<const T>;
 
 	private:
+		// Chunk followed by its position in chunks_. Wrappers have user-provided default constructors, otherwise
+		// constructing one would value-initialize it and write every slot of a new chunk.
+		struct indexed_chunk : chunk_type
+		{
+			indexed_chunk() noexcept {}
+
+			size_type index{};
+		};
+
+		// Slot position within a chunk on a remote free list, the maximum ends a list
+		using remote_slot = std::conditional_t<(ChunkCapacity < std::numeric_limits<std::uint16_t>::max()), std::uint16_t, std::uint32_t>;
+		static constexpr remote_slot remote_npos = std::numeric_limits<remote_slot>::max();
+
+		// Slots erased from other threads are pushed onto remote_head and linked through remote_next.
+		// The push onto an empty list also pushes the chunk onto remote_chunks_, linked through remote_next_chunk.
+		struct remote_free_chunk : indexed_chunk
+		{
+			remote_free_chunk() noexcept {}
+
+			std::atomic<remote_slot> remote_head{ remote_npos };
+			remote_free_chunk* remote_next_chunk = nullptr;
+
+			// Written by the push that links a slot in, never read before that
+			std::array<remote_slot, ChunkCapacity> remote_next;
+		};
+
+		using aligned_chunk = std::conditional_t<remote_free, remote_free_chunk, indexed_chunk>;
+
+		// Aligned chunks are allocated at their size rounded up to a power of two,
+		// every slot is within chunk_alignment bytes of the chunk's address
+		static constexpr std::size_t chunk_alignment = std::bit_ceil(sizeof(aligned_chunk));
+
+		static_assert(!aligned_chunks || chunk_alignment <= aligned_chunk_lookup_policy::max_chunk_alignment,
+			"free_list<T> chunks are too large for aligned_chunk_lookup_policy, use a smaller ChunkCapacity.");
+
+		// Allocates aligned chunks at chunk_alignment through allocator_type, asking for only sizeof(aligned_chunk) bytes.
+		// std::allocator and std::pmr::polymorphic_allocator are asked for the alignment, other allocators are asked
+		// for enough bytes to align the chunk within them, with the start of the allocation stored in front of the chunk.
+		// Every other type is allocated by allocator_type as is.
+		template<class U>
+		class aligned_chunk_allocator
+		{
+			template<class>
+			friend class aligned_chunk_allocator;
+
+			using inner_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<U>;
+			using byte_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<std::byte>;
+
+			[[no_unique_address]] inner_allocator inner_;
+
+		public:
+			using value_type = U;
+			using propagate_on_container_copy_assignment = typename std::allocator_traits<inner_allocator>::propagate_on_container_copy_assignment;
+			using propagate_on_container_move_assignment = typename std::allocator_traits<inner_allocator>::propagate_on_container_move_assignment;
+			using propagate_on_container_swap = typename std::allocator_traits<inner_allocator>::propagate_on_container_swap;
+			using is_always_equal = typename std::allocator_traits<inner_allocator>::is_always_equal;
+
+			template<class V>
+			struct rebind
+			{
+				using other = aligned_chunk_allocator<V>;
+			};
+
+			aligned_chunk_allocator() = default;
+
+			explicit aligned_chunk_allocator(const allocator_type& allocator) noexcept
+				: inner_(allocator) {}
+
+			template<class V>
+			aligned_chunk_allocator(const aligned_chunk_allocator<V>& other) noexcept
+				: inner_(other.inner_) {}
+
+			explicit operator allocator_type() const noexcept
+			{
+				return allocator_type(inner_);
+			}
+
+			[[nodiscard]] aligned_chunk_allocator select_on_container_copy_construction() const
+			{
+				return aligned_chunk_allocator(static_cast<allocator_type>(std::allocator_traits<inner_allocator>::select_on_container_copy_construction(inner_)));
+			}
+
+			[[nodiscard]] U* allocate(std::size_t n)
+			{
+				if constexpr (!std::is_same_v<U, aligned_chunk>)
+				{
+					return std::allocator_traits<inner_allocator>::allocate(inner_, n);
+				}
+				else if constexpr (std::is_same_v<inner_allocator, std::allocator<U>>)
+				{
+					return static_cast<U*>(::operator new(n * sizeof(U), std::align_val_t{ chunk_alignment }));
+				}
+				else if constexpr (std::is_same_v<inner_allocator, std::pmr::polymorphic_allocator<U>>)
+				{
+					return static_cast<U*>(inner_.allocate_bytes(n * sizeof(U), chunk_alignment));
+				}
+				else
+				{
+					byte_allocator bytes(inner_);
+					std::byte* first = std::allocator_traits<byte_allocator>::allocate(bytes, padded_size(n));
+
+					const auto address = (reinterpret_cast<std::uintptr_t>(first) + sizeof(std::byte*) + chunk_alignment - 1) & ~static_cast<std::uintptr_t>(chunk_alignment - 1);
+					std::memcpy(reinterpret_cast<std::byte*>(address) - sizeof(std::byte*), &first, sizeof(std::byte*));
+
+					return reinterpret_cast<U*>(address);
+				}
+			}
+
+			void deallocate(U* ptr, std::size_t n) noexcept
+			{
+				if constexpr (!std::is_same_v<U, aligned_chunk>)
+				{
+					std::allocator_traits<inner_allocator>::deallocate(inner_, ptr, n);
+				}
+				else if constexpr (std::is_same_v<inner_allocator, std::allocator<U>>)
+				{
+					::operator delete(ptr, n * sizeof(U), std::align_val_t{ chunk_alignment });
+				}
+				else if constexpr (std::is_same_v<inner_allocator, std::pmr::polymorphic_allocator<U>>)
+				{
+					inner_.deallocate_bytes(ptr, n * sizeof(U), chunk_alignment);
+				}
+				else
+				{
+					std::byte* first;
+					std::memcpy(&first, reinterpret_cast<std::byte*>(ptr) - sizeof(std::byte*), sizeof(std::byte*));
+
+					byte_allocator bytes(inner_);
+					std::allocator_traits<byte_allocator>::deallocate(bytes, first, padded_size(n));
+				}
+			}
+
+			[[nodiscard]] friend bool operator==(const aligned_chunk_allocator& lhs, const aligned_chunk_allocator& rhs) noexcept
+			{
+				return lhs.inner_ == rhs.inner_;
+			}
+
+		private:
+			[[nodiscard]] static constexpr std::size_t padded_size(std::size_t n) noexcept
+			{
+				return n * sizeof(U) + sizeof(std::byte*) + chunk_alignment - 1;
+			}
+		};
+
+		using stored_chunk_type = std::conditional_t<aligned_chunks, aligned_chunk, chunk_type>;
+		using chunk_allocator = std::conditional_t<aligned_chunks,
+			aligned_chunk_allocator<stored_chunk_type>,
+			typename std::allocator_traits<allocator_type>::template rebind_alloc<stored_chunk_type>>;
+
+		// Chunks are visited through the pointers chunks_ stores, as const so they can't be changed behind the list's back
+		using const_chunk_iterator = ::fox::iterator::indirect_iterator<const stored_chunk_type* const*>;
+
+	private:
+		// Entry of the address sorted chunk index, first is the chunk's first slot so searching doesn't touch the chunks
+		struct chunk_entry
+		{
+			const_pointer first;
+			size_type index;
+		};
+
+		using chunk_entry_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<chunk_entry>;
+
 		struct chunk_less
 		{
 			using is_transparent = void;
 
-			[[nodiscard]] bool operator()(const chunk_type& lhs, const chunk_type& rhs) const noexcept
+			[[nodiscard]] bool operator()(const chunk_entry& lhs, const chunk_entry& rhs) const noexcept
+			{
+				return std::less<const_pointer>{}(lhs.first, rhs.first);
+			}
+
+			[[nodiscard]] bool operator()(const chunk_entry& lhs, const_pointer rhs) const noexcept
+			{
+				return std::less<const_pointer>{}(lhs.first, rhs);
+			}
+
+			[[nodiscard]] bool operator()(const_pointer lhs, const chunk_entry& rhs) const noexcept
+			{
+				return std::less<const_pointer>{}(lhs, rhs.first);
+			}
+		};
+
+		// Bit per chunk with a summary bit per word on top, finding the first set bit visits one summary word per 4096 chunks
+		class chunk_bitmap
+		{
+			using word_type = std::uint64_t;
+			using word_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<word_type>;
+
+			static constexpr std::size_t word_bits = std::numeric_limits<word_type>::digits;
+
+			std::vector<word_type, word_allocator> words_;
+			std::vector<word_type, word_allocator> summary_;
+
+		public:
+			chunk_bitmap() = default;
+
+			explicit chunk_bitmap(const allocator_type& allocator)
+				: words_(static_cast<word_allocator>(allocator)), summary_(static_cast<word_allocator>(allocator)) {}
+
+			// Bits added by growing are cleared
+			void resize(std::size_t count)
 			{
-				return lhs.data() < rhs.data();
+				words_.resize((count + word_bits - 1) / word_bits);
+				summary_.resize((std::size(words_) + word_bits - 1) / word_bits);
+
+				if (count % word_bits != 0)
+					words_.back() &= (word_type{ 1 } << (count % word_bits)) - 1;
+
+				if (std::size(words_) % word_bits != 0)
+					summary_.back() &= (word_type{ 1 } << (std::size(words_) % word_bits)) - 1;
+
+				if (!std::empty(words_) && words_.back() == 0)
+					summary_.back() &= ~(word_type{ 1 } << ((std::size(words_) - 1) % word_bits));
 			}
 
-			[[nodiscard]] bool operator()(const chunk_type& lhs, const_pointer rhs) const noexcept
+			void set(std::size_t idx) noexcept
 			{
-				return lhs.data() < rhs;
+				const std::size_t word = idx / word_bits;
+
+				words_[word] |= word_type{ 1 } << (idx % word_bits);
+				summary_[word / word_bits] |= word_type{ 1 } << (word % word_bits);
 			}
 
-			[[nodiscard]] bool operator()(const_pointer lhs, const chunk_type& rhs) const noexcept
+			void reset(std::size_t idx) noexcept
 			{
-				return lhs < rhs.data();
+				const std::size_t word = idx / word_bits;
+
+				words_[word] &= ~(word_type{ 1 } << (idx % word_bits));
+
+				if (words_[word] == 0)
+					summary_[word / word_bits] &= ~(word_type{ 1 } << (word % word_bits));
 			}
+
+			[[nodiscard]] std::size_t find_first() const noexcept
+			{
+				for (std::size_t i{}; i < std::size(summary_); ++i)
+				{
+					if (summary_[i] != 0)
+					{
+						const std::size_t word = i * word_bits + static_cast<std::size_t>(std::countr_zero(summary_[i]));
+						return word * word_bits + static_cast<std::size_t>(std::countr_zero(words_[word]));
+					}
+				}
+
+				return npos;
+			}
+		};
+
+		fox::ptr_vector<stored_chunk_type, chunk_allocator> chunks_;
+
+		// Set for every chunk with a free slot, updated whenever free_list emplaces into or erases from a chunk
+		chunk_bitmap non_full_;
+
+		// Every chunk ordered by address, finds the chunk owning a pointer in O(log chunks).
+		// A tree rather than a sorted array, new chunks often land in holes between existing ones.
+		// With aligned_chunk_lookup_policy only owns() searches it, a pointer that isn't owned can't be masked.
+		std::set<chunk_entry, chunk_less, chunk_entry_allocator> chunk_index_;
+
+		// Number of values in all chunks
+		size_type size_{};
+
+		// Number of allocated chunks without a value
+		size_type empty_chunks_{};
+
+		// Up to this many empty chunks are kept allocated by erase and optimize
+		size_type empty_chunk_retention_{};
+
+		struct no_remote_chunks {};
+
+		// Stack of chunks with values erased through remote_erase, taken whole by collect_remote_frees
+#if __has_cpp_attribute(msvc::no_unique_address)
+		[[msvc::no_unique_address]]
+#elif __has_cpp_attribute(no_unique_address)
+		[[no_unique_address]]
+#endif
+		std::conditional_t<remote_free, std::atomic<remote_free_chunk*>, no_remote_chunks> remote_chunks_{};
+
+		// Image written by snapshot(), in native byte order: header followed by the image of every chunk
+		struct snapshot_header
+		{
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint64_t chunk_count;
 		};
 
-		fox::ptr_vector<inplace_free_list<T, ChunkCapacity>, chunk_allocator> chunks_;
+		static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+		static constexpr std::uint32_t snapshot_magic = 0x534C5846; // "FXLS"
+		static constexpr std::uint32_t snapshot_version = 1;
 
 	public:
 		free_list() = default;
 
 		free_list(const allocator_type& allocator)
-			: chunks_(static_cast<chunk_allocator>(allocator)) {}
-
-		free_list(const free_list& other) = default;
+			: chunks_(static_cast<chunk_allocator>(allocator)), non_full_(allocator), chunk_index_(static_cast<chunk_entry_allocator>(allocator)) {}
+
+		// Values erased from other threads can't be collected from a const list, so lists with remote free lists
+		// can't be copied or transformed
+		free_list(const free_list& other) requires (!remote_free)
+			: chunks_(other.chunks_), non_full_(other.non_full_),
+			chunk_index_(std::allocator_traits<chunk_entry_allocator>::select_on_container_copy_construction(other.chunk_index_.get_allocator())),
+			size_(other.size_), empty_chunks_(other.empty_chunks_), empty_chunk_retention_(other.empty_chunk_retention_)
+		{
+			rebuild_chunk_index();
+		}
 
 		template<class U, class OtherAllocator, class TransformFunc>
-		free_list(const free_list<U, ChunkCapacity, OtherAllocator>& other, TransformFunc func)
-			requires (std::is_invocable_r_v<T, TransformFunc, const U&>)
+		free_list(const free_list<U, ChunkCapacity, OtherAllocator, AllocationPolicy, LayoutPolicy, ChunkLookupPolicy, IndexPolicy, RemoteFreePolicy>& other, TransformFunc func)
+			requires (!remote_free && std::is_invocable_r_v<T, TransformFunc, const U&>)
 		{
 			this->assign(other, std::move(func));
 		}
 
-		free_list(free_list&& other) noexcept = default;
-		free_list& operator=(const free_list& other) = default;
-		free_list& operator=(free_list&& other) noexcept = default;
+		// Moves are noexcept when moving every member is, as with the standard containers the allocator decides that
+		free_list(free_list&& other) noexcept(std::is_nothrow_move_constructible_v<decltype(chunks_)> &&
+			std::is_nothrow_move_constructible_v<chunk_bitmap> && std::is_nothrow_move_constructible_v<decltype(chunk_index_)>)
+			: chunks_(std::move(other.chunks_)), non_full_(std::move(other.non_full_)), chunk_index_(std::move(other.chunk_index_)),
+			size_(std::exchange(other.size_, 0)), empty_chunks_(std::exchange(other.empty_chunks_, 0)),
+			empty_chunk_retention_(other.empty_chunk_retention_)
+		{
+			if constexpr (remote_free)
+				remote_chunks_.store(other.remote_chunks_.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+
+		free_list& operator=(const free_list& other) requires (!remote_free)
+		{
+			if (this != std::addressof(other))
+			{
+				chunks_ = other.chunks_;
+				non_full_ = other.non_full_;
+				size_ = other.size_;
+				empty_chunks_ = other.empty_chunks_;
+				empty_chunk_retention_ = other.empty_chunk_retention_;
+				rebuild_chunk_index();
+			}
+
+			return *this;
+		}
+
+		free_list& operator=(free_list&& other) noexcept(std::is_nothrow_move_assignable_v<decltype(chunks_)> &&
+			std::is_nothrow_move_assignable_v<chunk_bitmap> && std::is_nothrow_move_assignable_v<decltype(chunk_index_)>)
+		{
+			if (this != std::addressof(other))
+			{
+				chunks_ = std::move(other.chunks_);
+				non_full_ = std::move(other.non_full_);
+				chunk_index_ = std::move(other.chunk_index_);
+				size_ = std::exchange(other.size_, 0);
+				empty_chunks_ = std::exchange(other.empty_chunks_, 0);
+				empty_chunk_retention_ = other.empty_chunk_retention_;
+
+				// Unequal allocators that don't propagate move chunks into new allocations, other keeps the emptied ones
+				if (!std::empty(other.chunks_))
+				{
+					rebuild_chunk_index();
+
+					other.chunks_.clear();
+					other.non_full_.resize(0);
+					other.chunk_index_.clear();
+				}
+
+				if constexpr (remote_free)
+					remote_chunks_.store(other.remote_chunks_.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+			}
+
+			return *this;
+		}
+
 		~free_list() noexcept = default;
 
 	public:
@@ -84,6 +587,15 @@ namespace fox
 			return ChunkCapacity;
 		}
 
+		// Most chunks the index encoding can address
+		[[nodiscard]] static constexpr size_type max_chunk_count() noexcept
+		{
+			if constexpr (chunk_bits >= static_cast<std::size_t>(std::numeric_limits<size_type>::digits))
+				return std::numeric_limits<size_type>::max();
+			else
+				return size_type{ 1 } << chunk_bits;
+		}
+
 		[[nodiscard]] size_type capacity() const noexcept
 		{
 			return std::size(chunks_) * chunk_capacity();
@@ -91,22 +603,35 @@ namespace fox
 
 		[[nodiscard]] size_type size() const noexcept
 		{
-			size_type out{};
-			for (const auto& c : chunks_)
-				out += c.size();
-
-			return out;
+			return size_;
 		}
 
 		[[nodiscard]] bool empty() const noexcept
 		{
-			return size() == static_cast<size_type>(0);
+			return size_ == static_cast<size_type>(0);
+		}
+
+		[[nodiscard]] free_list_statistics statistics() const noexcept
+		{
+			return { size_, capacity(), std::size(chunks_), empty_chunks_ };
+		}
+
+		[[nodiscard]] size_type empty_chunk_retention() const noexcept
+		{
+			return empty_chunk_retention_;
+		}
+
+		// Keeps up to count empty chunks allocated, so a size oscillating around a chunk boundary doesn't
+		// allocate and free a chunk every time. Takes effect on the next erase or optimize.
+		void set_empty_chunk_retention(size_type count) noexcept
+		{
+			empty_chunk_retention_ = count;
 		}
 
 	public:
 		template<class U, class OtherAllocator, class TransformFunc>
-		void assign(const free_list<U, ChunkCapacity, OtherAllocator>& other, TransformFunc func)
-			requires (std::is_invocable_r_v<T, TransformFunc, const U&>)
+		void assign(const free_list<U, ChunkCapacity, OtherAllocator, AllocationPolicy, LayoutPolicy, ChunkLookupPolicy, IndexPolicy, RemoteFreePolicy>& other, TransformFunc func)
+			requires (!remote_free && std::is_invocable_r_v<T, TransformFunc, const U&>)
 		{
 			this->clear();
 
@@ -116,36 +641,92 @@ namespace fox
 			{
 				chunks_[i].assign(other.chunks_[i], func);
 			}
+
+			size_ = other.size_;
+
+			rebuild_chunk_occupancy();
+			rebuild_chunk_index();
 		}
 
 	public:
 		void clear()
 		{
 			chunks_.clear();
+			non_full_.resize(0);
+			chunk_index_.clear();
+			size_ = 0;
+			empty_chunks_ = 0;
+
+			if constexpr (remote_free)
+				remote_chunks_.store(nullptr, std::memory_order_relaxed);
 		}
 
+		// Frees the empty chunks at the back beyond the retained ones and returns unused directory capacity.
+		// Chunks are never reordered, so pointers and indices stay valid. Empty chunks before a chunk with values
+		// are kept for that reason, they are refilled before any later chunk.
 		void optimize()
 		{
-
+			release_back_chunks();
+			chunks_.shrink_to_fit();
 		}
 
 		template<class... Args>
 		[[nodiscard]] T* emplace(Args&&... args) requires(std::is_constructible_v<value_type, Args...>)
 		{
-			chunk_type* allocation_chunk;
+			if constexpr (remote_free)
+				(void)collect_remote_frees();
 
-			// Find first free
-			if(auto r = std::find_if(std::begin(chunks_), std::end(chunks_), [](const auto& v) { return v.full() == false; });
-				r != std::end(chunks_))
-			{
-				allocation_chunk = std::addressof(*r);
-			}
-			else
+			const size_type chunk = allocation_chunk();
+
+			const bool was_empty = chunks_[chunk].empty();
+
+			T* out = chunks_[chunk].emplace(std::forward<Args>(args)...);
+			update_non_full(chunk);
+			++size_;
+
+			if (was_empty)
+				--empty_chunks_;
+
+			return out;
+		}
+
+		// Emplaces count values constructed from args and writes pointers to them to out, filling a chunk per call
+		template<std::output_iterator<T*> OutputIt, class... Args>
+		OutputIt emplace_n(size_type count, OutputIt out, const Args&... args) requires(std::is_constructible_v<value_type, const Args&...>)
+		{
+			if constexpr (remote_free)
+				(void)collect_remote_frees();
+
+			while (count != 0)
 			{
-				allocation_chunk = std::addressof(chunks_.emplace_back());
+				const size_type chunk = allocation_chunk();
+				const size_type before = chunks_[chunk].size();
+				const size_type n = std::min(count, chunks_[chunk].capacity() - before);
+
+				try
+				{
+					out = chunks_[chunk].emplace_n(n, std::move(out), args...);
+				}
+				catch (...)
+				{
+					// Values constructed before the throw are kept by the chunk
+					size_ += chunks_[chunk].size() - before;
+					if (before == 0 && !chunks_[chunk].empty())
+						--empty_chunks_;
+
+					update_non_full(chunk);
+					std::rethrow_exception(std::current_exception());
+				}
+
+				update_non_full(chunk);
+				size_ += n;
+				if (before == 0 && n != 0)
+					--empty_chunks_;
+
+				count -= n;
 			}
 
-			return allocation_chunk->emplace(std::forward<Args>(args)...);
+			return out;
 		}
 
 		[[nodiscard]] T* insert(const T& value) requires(std::is_copy_constructible_v<T>)
@@ -161,25 +742,168 @@ namespace fox
 	public:
 		void erase(const T* ptr)
 		{
-			auto chunk = owning_chunk(ptr);
-			chunk->erase(ptr);
+			const size_type chunk = owning_chunk_index(ptr);
+			chunks_[chunk].erase(ptr);
+			non_full_.set(chunk);
+			--size_;
 
-			auto last_chunk_it = --chunks_.end();
-			if(chunk->empty() && std::addressof(*last_chunk_it) == chunk)
+			if (chunks_[chunk].empty())
 			{
-				chunks_.pop_back();
+				++empty_chunks_;
+				release_back_chunks();
+			}
+		}
+
+		// Erases every value pointed to by the range, consecutive pointers into the same chunk skip the chunk lookup
+		template<std::ranges::input_range R>
+		void erase_n(R&& pointers) requires (std::convertible_to<std::ranges::range_reference_t<R>, const T*>)
+		{
+			size_type chunk = std::size(chunks_);
+			for (const T* ptr : pointers)
+			{
+				if (chunk == std::size(chunks_) || !chunks_[chunk].owns(ptr))
+					chunk = owning_chunk_index(ptr);
+
+				chunks_[chunk].erase(ptr);
+				non_full_.set(chunk);
+				--size_;
+				if (chunks_[chunk].empty())
+					++empty_chunks_;
+			}
+
+			release_back_chunks();
+		}
+
+		// Erases ptr from any thread, concurrently with the owning thread and other remote_erase calls, without locking.
+		// The value stays alive and counted by size() until the owning thread collects it on its next emplace
+		// or collect_remote_frees, the list mustn't be moved, cleared or destroyed while remote_erase runs.
+		void remote_erase(const T* ptr) noexcept requires (remote_free)
+		{
+			// Masking doesn't read the list, whose bookkeeping the owning thread may be changing
+			const auto address = reinterpret_cast<std::uintptr_t>(ptr) & ~static_cast<std::uintptr_t>(chunk_alignment - 1);
+			auto chunk = static_cast<remote_free_chunk*>(reinterpret_cast<aligned_chunk*>(address));
+			const auto slot = static_cast<remote_slot>(chunk->as_index(ptr));
+
+			// Acquire on success pairs with collect_remote_frees emptying the list, so the write of remote_next_chunk
+			// below happens after the owning thread's read of it
+			remote_slot head = chunk->remote_head.load(std::memory_order_relaxed);
+			do
+			{
+				chunk->remote_next[slot] = head;
+			}
+			while (!chunk->remote_head.compare_exchange_weak(head, slot, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+			// Later pushes are collected together with the first one, the chunk is queued once
+			if (head != remote_npos)
+				return;
+
+			remote_free_chunk* top = remote_chunks_.load(std::memory_order_relaxed);
+			do
+			{
+				chunk->remote_next_chunk = top;
+			}
+			while (!remote_chunks_.compare_exchange_weak(top, chunk, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		// Destroys the values erased through remote_erase so far and frees their slots, returns how many were collected.
+		// Only the owning thread may call it, emplace and emplace_n call it first.
+		size_type collect_remote_frees() requires (remote_free)
+		{
+			if (remote_chunks_.load(std::memory_order_relaxed) == nullptr)
+				return 0;
+
+			size_type out{};
+			for (remote_free_chunk* chunk = remote_chunks_.exchange(nullptr, std::memory_order_acquire); chunk != nullptr;)
+			{
+				// Read before taking the chunk's list, a remote_erase onto the taken list queues the chunk again
+				remote_free_chunk* next = chunk->remote_next_chunk;
+
+				for (remote_slot slot = chunk->remote_head.exchange(remote_npos, std::memory_order_acq_rel); slot != remote_npos;)
+				{
+					const remote_slot following = chunk->remote_next[slot];
+
+					chunk->erase((*chunk)[slot]);
+					non_full_.set(chunk->index);
+					--size_;
+					++out;
+
+					slot = following;
+				}
+
+				// Queued chunks hold at least one value until collected
+				if (chunk->empty())
+					++empty_chunks_;
+
+				chunk = next;
 			}
+
+			release_back_chunks();
+			return out;
 		}
 
 	public:
-		[[nodiscard]] bool owns(const T* ptr) const noexcept
+		// Size in bytes of the image snapshot() writes
+		[[nodiscard]] size_type snapshot_size() const noexcept
+		{
+			size_type out = sizeof(snapshot_header);
+			for (const auto& c : chunks_)
+				out += c.snapshot_size();
+
+			return out;
+		}
+
+		// Writes one image per chunk, restoring them gives back the values at the same indices
+		template<std::output_iterator<std::uint8_t> OutputIt>
+		OutputIt snapshot(OutputIt out) const requires (std::is_trivially_copyable_v<T>)
 		{
-			if (std::empty(chunks_))
-				return false;
+			const snapshot_header header{ snapshot_magic, snapshot_version, std::size(chunks_) };
+
+			const auto bytes = reinterpret_cast<const std::uint8_t*>(std::addressof(header));
+			out = std::copy(bytes, bytes + sizeof(header), std::move(out));
+
+			for (const auto& c : chunks_)
+				out = c.snapshot(std::move(out));
+
+			return out;
+		}
+
+		// Replaces the contents with an image written by snapshot(), chunks are allocated with the current allocator.
+		// Returns the number of bytes read, throws std::invalid_argument and leaves the list unchanged when image isn't valid.
+		size_type restore(std::span<const std::uint8_t> image) requires (std::is_trivially_copyable_v<T>)
+		{
+			snapshot_header header;
+			if (std::size(image) < sizeof(header))
+				throw std::invalid_argument("free_list<T> snapshot is truncated.");
+
+			std::memcpy(std::addressof(header), std::data(image), sizeof(header));
+
+			if (header.magic != snapshot_magic || header.version != snapshot_version)
+				throw std::invalid_argument("free_list<T> snapshot has unknown format.");
 
-			auto r = std::find_if(std::begin(chunks_), std::end(chunks_), [=](const auto& c) { return c.owns(ptr); });
+			if (header.chunk_count > max_chunk_count())
+				throw std::invalid_argument("free_list<T> snapshot has more chunks than the index can address.");
 
-			return r != std::end(chunks_);
+			free_list restored(get_allocator());
+			restored.empty_chunk_retention_ = empty_chunk_retention_;
+			size_type offset = sizeof(header);
+
+			for (std::uint64_t i{}; i < header.chunk_count; ++i)
+			{
+				offset += restored.chunks_.emplace_back().restore(image.subspan(offset));
+				restored.size_ += restored.chunks_.back().size();
+			}
+
+			restored.rebuild_chunk_occupancy();
+			restored.rebuild_chunk_index();
+
+			*this = std::move(restored);
+			return offset;
+		}
+
+	public:
+		[[nodiscard]] bool owns(const T* ptr) const noexcept
+		{
+			return find_chunk(ptr) != npos;
 		}
 
 		[[nodiscard]] bool holds_value(const T* ptr) const noexcept
@@ -188,21 +912,16 @@ namespace fox
 			return chunk->holds_value(ptr);
 		}
 
-		[[nodiscard]] size_t as_index(const T* ptr) const noexcept
+		[[nodiscard]] index_type as_index(const T* ptr) const noexcept
 		{
-			assert(!std::empty(chunks_) && "free_list<T> doesn't own this pointer.");
-
-			auto chunk_it = std::find_if(std::begin(chunks_), std::end(chunks_), [=](const auto& c) { return c.owns(ptr); });
-			assert(chunk_it != std::end(chunks_) && "free_list<T> doesn't own this pointer.");
+			const size_type chunk = owning_chunk_index(ptr);
+			const size_type index = chunks_[chunk].as_index(ptr);
 
-			auto chunk = std::distance(std::begin(chunks_), chunk_it);
-			auto index = chunk_it->as_index(ptr);
-
-			return pack_index(static_cast<std::uint16_t>(chunk), static_cast<std::uint16_t>(index));
+			return pack_index(chunk, index);
 		}
 
 	public:
-		[[nodiscard]] const T* operator[](size_type idx) const noexcept
+		[[nodiscard]] const T* operator[](index_type idx) const noexcept
 		{
 			auto [chunk, index] = unpack_index(idx);
 
@@ -210,7 +929,7 @@ namespace fox
 			return chunk_ptr->operator[](index);
 		}
 
-		[[nodiscard]] T* operator[](size_type idx) noexcept
+		[[nodiscard]] T* operator[](index_type idx) noexcept
 		{
 			auto [chunk, index] = unpack_index(idx);
 
@@ -218,7 +937,7 @@ namespace fox
 			return chunk_ptr->operator[](index);
 		}
 
-		[[nodiscard]] bool holds_value_at(size_type idx) const noexcept
+		[[nodiscard]] bool holds_value_at(index_type idx) const noexcept
 		{
 			auto [chunk, index] = unpack_index(idx);
 
@@ -228,38 +947,36 @@ namespace fox
 			return chunk_ptr->holds_value_at(index);
 		}
 
-		[[nodiscard]] const T* at(size_type idx) const
+		[[nodiscard]] const T* at(index_type idx) const
 		{
 			auto [chunk, index] = unpack_index(idx);
 
+			if (chunk >= std::size(chunks_))
+				throw std::out_of_range("Index is out of range.");
+
 			auto chunk_ptr = std::data(chunks_)[chunk];
 			return chunk_ptr->at(index);
 		}
 
-		[[nodiscard]] T* at(size_type idx)
+		[[nodiscard]] T* at(index_type idx)
 		{
 			auto [chunk, index] = unpack_index(idx);
 
+			if (chunk >= std::size(chunks_))
+				throw std::out_of_range("Index is out of range.");
+
 			auto chunk_ptr = std::data(chunks_)[chunk];
 			return chunk_ptr->at(index);
 		}
 
 	public:
-		[[nodiscard]] chunk_type* owning_chunk(const T* ptr) noexcept
-		{
-			const auto chunk = owning_chunk_no_assert(ptr);
-			assert(chunk != nullptr && "free_list<T> doesn't own this pointer.");
-			return chunk;
-		}
-
+		// Chunks are only exposed for reading, every emplace and erase goes through free_list so its counts stay exact
 		[[nodiscard]] const chunk_type* owning_chunk(const T* ptr) const noexcept
 		{
-			const auto chunk = owning_chunk_no_assert(ptr);
-			assert(chunk != nullptr && "free_list<T> doesn't own this pointer.");
-			return chunk;
+			return std::addressof(chunks_[owning_chunk_index(ptr)]);
 		}
 
-		[[nodiscard]] chunk_type* owning_chunk(size_type idx) noexcept
+		[[nodiscard]] const chunk_type* owning_chunk(index_type idx) const noexcept
 		{
 			auto [chunk, index] = unpack_index(idx);
 
@@ -270,88 +987,227 @@ namespace fox
 			return std::addressof(*chunk_it);
 		}
 
-		[[nodiscard]] const chunk_type* owning_chunk(size_type idx) const noexcept
+		[[nodiscard]] const_chunk_iterator chunks_begin() const noexcept { return const_chunk_iterator(chunks_.data()); }
+		[[nodiscard]] const_chunk_iterator chunks_cbegin() const noexcept { return chunks_begin(); }
+		[[nodiscard]] const_chunk_iterator chunks_end() const noexcept { return const_chunk_iterator(chunks_.data() + std::size(chunks_)); }
+		[[nodiscard]] const_chunk_iterator chunks_cend() const noexcept { return chunks_end(); }
+
+		[[nodiscard]] auto chunks_rbegin() const noexcept { return std::make_reverse_iterator(chunks_end()); }
+		[[nodiscard]] auto chunks_crbegin() const noexcept { return chunks_rbegin(); }
+		[[nodiscard]] auto chunks_rend() const noexcept { return std::make_reverse_iterator(chunks_begin()); }
+		[[nodiscard]] auto chunks_crend() const noexcept { return chunks_rend(); }
+
+	public:
+		// Live elements of every chunk in chunk order, a forward range usable with standard algorithms and views
+		[[nodiscard]] iterator begin() noexcept
+		{
+			return iterator(this, 0);
+		}
+
+		[[nodiscard]] const_iterator begin() const noexcept
 		{
-			auto [chunk, index] = unpack_index(idx);
+			return const_iterator(this, 0);
+		}
 
-			assert(chunk < std::size(chunks_) && "free_list<T> doesn't own this pointer.");
+		[[nodiscard]] const_iterator cbegin() const noexcept
+		{
+			return this->begin();
+		}
 
-			auto chunk_it = std::begin(chunks_) + chunk;
+		[[nodiscard]] iterator end() noexcept
+		{
+			return iterator(this, std::size(chunks_));
+		}
 
-			return std::addressof(*chunk_it);
+		[[nodiscard]] const_iterator end() const noexcept
+		{
+			return const_iterator(this, std::size(chunks_));
+		}
+
+		[[nodiscard]] const_iterator cend() const noexcept
+		{
+			return this->end();
 		}
 
-		[[nodiscard]] auto chunks_begin() noexcept { return std::begin(chunks_); }
-		[[nodiscard]] auto chunks_begin() const noexcept { return std::begin(chunks_); }
-		[[nodiscard]] auto chunks_cbegin() const noexcept { return std::cbegin(chunks_); }
-		[[nodiscard]] auto chunks_end() noexcept { return std::end(chunks_); }
-		[[nodiscard]] auto chunks_end() const noexcept { return std::end(chunks_); }
-		[[nodiscard]] auto chunks_cend() const noexcept { return std::cend(chunks_); }
+		// Invokes func on every live element, cheaper than iterating with begin() / end()
+		template<class Func>
+		void for_each_live(Func&& func) requires (std::is_invocable_v<Func&, T&>)
+		{
+			for (auto& c : chunks_)
+			{
+				if (!c.empty())
+					c.for_each_live(func);
+			}
+		}
 
-		[[nodiscard]] auto chunks_rbegin() noexcept { return std::rbegin(chunks_); }
-		[[nodiscard]] auto chunks_rbegin() const noexcept { return std::rbegin(chunks_); }
-		[[nodiscard]] auto chunks_crbegin() const noexcept { return std::crbegin(chunks_); }
-		[[nodiscard]] auto chunks_rend() noexcept { return std::rend(chunks_); }
-		[[nodiscard]] auto chunks_rend() const noexcept { return std::rend(chunks_); }
-		[[nodiscard]] auto chunks_crend() const noexcept { return std::crend(chunks_); }
+		template<class Func>
+		void for_each_live(Func&& func) const requires (std::is_invocable_v<Func&, const T&>)
+		{
+			for (const auto& c : chunks_)
+			{
+				if (!c.empty())
+					c.for_each_live(func);
+			}
+		}
 
 	private:
-		void assert_owns(const T* ptr) const
+		// Index of the first chunk with a free slot, a new chunk is appended if all are full
+		[[nodiscard]] size_type allocation_chunk()
 		{
-			assert(this->owns(ptr) == true && "free_list<T> doesn't own this pointer.");
+			if (const size_type chunk = non_full_.find_first(); chunk != npos)
+			{
+				assert(!chunks_[chunk].full() && "free_list<T> non-full chunk bitmap is out of date.");
+				return chunk;
+			}
+
+			const size_type chunk = std::size(chunks_);
+			if (chunk == max_chunk_count())
+				throw std::length_error("free_list<T> index can't address another chunk.");
+
+			non_full_.resize(chunk + 1);
+
+			chunks_.emplace_back();
+
+			if constexpr (aligned_chunks)
+				chunks_[chunk].index = chunk;
+
+			try
+			{
+				chunk_index_.insert({ chunks_[chunk].data(), chunk });
+			}
+			catch (...)
+			{
+				chunks_.pop_back();
+				non_full_.resize(chunk);
+				std::rethrow_exception(std::current_exception());
+			}
+
+			non_full_.set(chunk);
+			++empty_chunks_;
+			return chunk;
 		}
 
-		void assert_chunks_not_empty() const
+		void pop_chunk()
 		{
-			assert(!std::empty(chunks_));
+			const auto entry = chunk_index_.find(chunks_.back().data());
+			assert(entry != std::end(chunk_index_) && entry->index + 1 == std::size(chunks_));
+
+			assert(chunks_.back().empty());
+
+			chunk_index_.erase(entry);
+			chunks_.pop_back();
+			non_full_.resize(std::size(chunks_));
+			--empty_chunks_;
 		}
 
-		[[nodiscard]] chunk_type* owning_chunk_no_assert(const T* ptr) noexcept
+		// Frees empty chunks at the back while more empty chunks than retained are allocated,
+		// empty chunks before a chunk with values are kept so indices stay valid
+		void release_back_chunks()
 		{
-			if (std::empty(chunks_))
-				return nullptr;
+			while (empty_chunks_ > empty_chunk_retention_ && !std::empty(chunks_) && chunks_.back().empty())
+			{
+				pop_chunk();
+			}
+		}
 
-			auto r = std::find_if(std::begin(chunks_), std::end(chunks_), [=](const auto& c) { return c.owns(ptr); });
-			if (r == std::end(chunks_))
-				return nullptr;
+		void rebuild_chunk_index()
+		{
+			chunk_index_.clear();
 
-			return std::addressof(*r);
+			for (size_type i{}; i < std::size(chunks_); ++i)
+			{
+				if constexpr (aligned_chunks)
+					chunks_[i].index = i;
+
+				chunk_index_.insert({ chunks_[i].data(), i });
+			}
 		}
 
-		[[nodiscard]] const chunk_type* owning_chunk_no_assert(const T* ptr) const noexcept
+		// Index of the chunk owning ptr, npos if there is none
+		[[nodiscard]] size_type find_chunk(const T* ptr) const noexcept
 		{
-			if (std::empty(chunks_))
-				return nullptr;
+			// ptr can only belong to the last chunk starting at or before it
+			auto entry = chunk_index_.upper_bound(ptr);
+			if (entry == std::begin(chunk_index_))
+				return npos;
 
-			auto r = std::find_if(std::begin(chunks_), std::end(chunks_), [=](const auto& c) { return c.owns(ptr); });
-			if (r == std::end(chunks_))
-				return nullptr;
+			--entry;
+			return chunks_[entry->index].owns(ptr) ? entry->index : npos;
+		}
 
-			return std::addressof(*r);
+		void update_non_full(size_type chunk) noexcept
+		{
+			if (chunks_[chunk].full())
+				non_full_.reset(chunk);
 		}
 
-		[[nodiscard]] size_type pack_index(std::uint16_t chunk, std::uint16_t position) const noexcept
+		// Recomputes non_full_ and empty_chunks_ from the chunks
+		void rebuild_chunk_occupancy()
 		{
-			static_assert(ChunkCapacity < std::numeric_limits<std::uint16_t>::max());
-			assert(std::size(chunks_) < std::numeric_limits<std::uint16_t>::max());
-			static_assert(sizeof(size_type) >= sizeof(std::uint16_t) * 2);
+			non_full_.resize(0);
+			non_full_.resize(std::size(chunks_));
+			empty_chunks_ = 0;
 
-			const size_type out = (static_cast<size_type>(chunk) << (sizeof(position) * 8)) | static_cast<size_type>(position);
-			return out;
+			for (size_type i{}; i < std::size(chunks_); ++i)
+			{
+				if (!chunks_[i].full())
+					non_full_.set(i);
+
+				if (chunks_[i].empty())
+					++empty_chunks_;
+			}
+		}
+
+		[[nodiscard]] size_type owning_chunk_index(const T* ptr) const noexcept
+		{
+			if constexpr (aligned_chunks)
+			{
+				assert(this->owns(ptr) && "free_list<T> doesn't own this pointer.");
+
+				const auto address = reinterpret_cast<std::uintptr_t>(ptr) & ~static_cast<std::uintptr_t>(chunk_alignment - 1);
+				return reinterpret_cast<const aligned_chunk*>(address)->index;
+			}
+			else
+			{
+				const size_type chunk = find_chunk(ptr);
+				assert(chunk != npos && "free_list<T> doesn't own this pointer.");
+
+				return chunk;
+			}
 		}
 
-		[[nodiscard]] static std::pair<std::uint16_t, std::uint16_t> unpack_index(size_type index) noexcept
+		void assert_owns(const T* ptr) const
 		{
-			std::uint16_t position = static_cast<std::uint16_t>(index & static_cast<size_type>(0xFFFFu));
-			std::uint16_t chunk = static_cast<std::uint16_t>((index >> (sizeof(position) * 8)) & static_cast<size_type>(0xFFFFu));
+			assert(this->owns(ptr) == true && "free_list<T> doesn't own this pointer.");
+		}
 
-			return std::make_pair(chunk, position);
+		void assert_chunks_not_empty() const
+		{
+			assert(!std::empty(chunks_));
+		}
+
+		[[nodiscard]] static index_type pack_index(size_type chunk, size_type position) noexcept
+		{
+			assert(chunk < max_chunk_count());
+
+			if constexpr (slot_bits == 0)
+				return static_cast<index_type>(chunk);
+			else
+				return static_cast<index_type>((static_cast<index_type>(chunk) << slot_bits) | static_cast<index_type>(position));
+		}
+
+		[[nodiscard]] static std::pair<size_type, size_type> unpack_index(index_type index) noexcept
+		{
+			if constexpr (slot_bits == 0)
+				return std::make_pair(static_cast<size_type>(index), size_type{});
+			else
+				return std::make_pair(static_cast<size_type>(index >> slot_bits), static_cast<size_type>(index & ((index_type{ 1 } << slot_bits) - 1)));
 		}
 	};
 
 	namespace pmr
 	{
-		template<class T, std::size_t ChunkCapacity>
-		using free_list = ::fox::free_list<T, ChunkCapacity, std::pmr::polymorphic_allocator<T>>;
+		template<class T, std::size_t ChunkCapacity, class AllocationPolicy = lifo_allocation_policy, class LayoutPolicy = packed_layout_policy, class ChunkLookupPolicy = indexed_chunk_lookup_policy, class IndexPolicy = packed_index_policy<>, class RemoteFreePolicy = local_free_policy>
+		using free_list = ::fox::free_list<T, ChunkCapacity, std::pmr::polymorphic_allocator<T>, AllocationPolicy, LayoutPolicy, ChunkLookupPolicy, IndexPolicy, RemoteFreePolicy>;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <fox/free_list.hpp>
+
+#include <type_traits>
+#include <algorithm>
+#include <execution>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <utility>
+
+namespace fox
+{
+	struct free_list_parallel_access
+	{
+		template<class FreeList>
+		[[nodiscard]] static auto& chunks(FreeList& list) noexcept
+		{
+			return list.chunks_;
+		}
+	};
+
+	// Invokes func on every live element of list, chunks are the units of work handed to policy,
+	// so with a parallel policy func is invoked concurrently for elements of different chunks
+	template<class ExecutionPolicy, class T, std::size_t ChunkCapacity, class Allocator, class AllocationPolicy, class LayoutPolicy, class ChunkLookupPolicy, class IndexPolicy, class RemoteFreePolicy, class Func>
+	void parallel_for_each(ExecutionPolicy&& policy, free_list<T, ChunkCapacity, Allocator, AllocationPolicy, LayoutPolicy, ChunkLookupPolicy, IndexPolicy, RemoteFreePolicy>& list, Func func)
+		requires (std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>> && std::is_invocable_v<Func&, T&>)
+	{
+		auto& chunks = free_list_parallel_access::chunks(list);
+
+		std::for_each(std::forward<ExecutionPolicy>(policy), std::begin(chunks), std::end(chunks), [&](auto& c)
+			{
+				if (!c.empty())
+					c.for_each_live(func);
+			});
+	}
+
+	template<class ExecutionPolicy, class T, std::size_t ChunkCapacity, class Allocator, class AllocationPolicy, class LayoutPolicy, class ChunkLookupPolicy, class IndexPolicy, class RemoteFreePolicy, class Func>
+	void parallel_for_each(ExecutionPolicy&& policy, const free_list<T, ChunkCapacity, Allocator, AllocationPolicy, LayoutPolicy, ChunkLookupPolicy, IndexPolicy, RemoteFreePolicy>& list, Func func)
+		requires (std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>> && std::is_invocable_v<Func&, const T&>)
+	{
+		const auto& chunks = free_list_parallel_access::chunks(list);
+
+		std::for_each(std::forward<ExecutionPolicy>(policy), std::begin(chunks), std::end(chunks), [&](const auto& c)
+			{
+				if (!c.empty())
+					c.for_each_live(func);
+			});
+	}
+
+	// Reduces init and transform(value) of every live element of list with reduce, which has to be associative and commutative.
+	// Every chunk is reduced as one unit of work handed to policy, chunk results are then reduced together.
+	template<class ExecutionPolicy, class T, std::size_t ChunkCapacity, class Allocator, class AllocationPolicy, class LayoutPolicy, class ChunkLookupPolicy, class IndexPolicy, class RemoteFreePolicy, class U, class Reduce, class Transform>
+	[[nodiscard]] U parallel_transform_reduce(ExecutionPolicy&& policy, const free_list<T, ChunkCapacity, Allocator, AllocationPolicy, LayoutPolicy, ChunkLookupPolicy, IndexPolicy, RemoteFreePolicy>& list, U init, Reduce reduce, Transform transform)
+		requires (std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>> && std::is_invocable_r_v<U, Transform&, const T&> && std::is_invocable_r_v<U, Reduce&, U, U>)
+	{
+		const auto& chunks = free_list_parallel_access::chunks(list);
+
+		// Empty chunks have no value to start their reduction with
+		const auto reduce_chunk = [&](const auto& c) -> std::optional<U>
+		{
+			auto it = std::begin(c);
+			if (it == std::end(c))
+				return std::nullopt;
+
+			U out = transform(*it);
+			for (++it; it != std::end(c); ++it)
+				out = reduce(std::move(out), transform(*it));
+
+			return out;
+		};
+
+		const auto reduce_chunks = [&](std::optional<U> lhs, std::optional<U> rhs) -> std::optional<U>
+		{
+			if (!lhs)
+				return rhs;
+
+			if (!rhs)
+				return lhs;
+
+			return reduce(std::move(*lhs), std::move(*rhs));
+		};
+
+		std::optional<U> out = std::transform_reduce(std::forward<ExecutionPolicy>(policy), std::begin(chunks), std::end(chunks),
+			std::optional<U>{}, reduce_chunks, reduce_chunk);
+
+		return out ? reduce(std::move(init), std::move(*out)) : init;
+	}
+}
@@ -6,46 +6,271 @@
 #include <utility>
 #include <bitset>
 #include <cassert>
+#include <algorithm>
+#include <exception>
 #include <bit>
+#include <limits>
+#include <iterator>
+#include <ranges>
+#include <functional>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#endif
 
 namespace fox
 {
-	template<class T, std::size_t Capacity>
+	// Most recently erased slot is reused first
+	struct lifo_allocation_policy {};
+
+	// Lowest free slot is always reused first, keeping live values packed at the front of the storage
+	struct address_ordered_allocation_policy {};
+
+	// Slots are packed at sizeof(T) stride
+	struct packed_layout_policy {};
+
+	// Slot stride is rounded up to a whole number of cache lines and the header is kept on its own line,
+	// so values updated from different threads never share a cache line
+	struct cache_line_isolated_layout_policy
+	{
+#if defined(__cpp_lib_hardware_interference_size)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+		static constexpr std::size_t cache_line_size = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+		static constexpr std::size_t cache_line_size = 64;
+#endif
+	};
+
+	// Comparisons against a value recognized by predicate scans. When T is trivially copyable and the projection
+	// is std::identity or a pointer to a data member of the same arithmetic type as value, densely occupied words
+	// are tested with vector compares loaded straight from the storage instead of invoking a predicate per value.
+	template<class U>
+	struct equal_to_value
+	{
+		using scan_comparison = std::equal_to<>;
+
+		U value;
+
+		[[nodiscard]] constexpr bool operator()(const U& other) const noexcept(noexcept(other == value))
+		{
+			return other == value;
+		}
+	};
+
+	template<class U>
+	struct less_than_value
+	{
+		using scan_comparison = std::less<>;
+
+		U value;
+
+		[[nodiscard]] constexpr bool operator()(const U& other) const noexcept(noexcept(other < value))
+		{
+			return other < value;
+		}
+	};
+
+	template<class U>
+	struct greater_than_value
+	{
+		using scan_comparison = std::greater<>;
+
+		U value;
+
+		[[nodiscard]] constexpr bool operator()(const U& other) const noexcept(noexcept(other > value))
+		{
+			return other > value;
+		}
+	};
+
+	// Slot index and the generation of the slot at the time the handle was created
+	template<class Index, class Generation>
+	struct inplace_free_list_handle
+	{
+		Index index;
+		Generation generation;
+
+		[[nodiscard]] friend constexpr bool operator==(const inplace_free_list_handle&, const inplace_free_list_handle&) noexcept = default;
+	};
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+// Structure was padded due to alignment specifier, intended with cache_line_isolated_layout_policy
+#pragma warning(disable: 4324)
+#endif
+
+	// Generation - unsigned integer type of per slot generation counters used to validate handles, void disables them
+	template<class T, std::size_t Capacity, class AllocationPolicy = lifo_allocation_policy, class Generation = void, class LayoutPolicy = packed_layout_policy>
 	class inplace_free_list
 	{
-		template<class, std::size_t>
+		template<class, std::size_t, class, class, class>
 		friend class inplace_free_list;
 
-		// Type used to implement in place free list
+		static_assert(
+			std::is_same_v<AllocationPolicy, lifo_allocation_policy> ||
+			std::is_same_v<AllocationPolicy, address_ordered_allocation_policy>,
+			"inplace_free_list<T> unknown allocation policy."
+		);
+
+		static constexpr bool address_ordered = std::is_same_v<AllocationPolicy, address_ordered_allocation_policy>;
+
+		static_assert(std::is_void_v<Generation> || std::unsigned_integral<Generation>, "inplace_free_list<T> generation has to be an unsigned integer.");
+
+		static constexpr bool generational = !std::is_void_v<Generation>;
+
+		static_assert(
+			std::is_same_v<LayoutPolicy, packed_layout_policy> ||
+			std::is_same_v<LayoutPolicy, cache_line_isolated_layout_policy>,
+			"inplace_free_list<T> unknown layout policy."
+		);
+
+		static constexpr bool cache_line_isolated = std::is_same_v<LayoutPolicy, cache_line_isolated_layout_policy>;
+
+		static constexpr std::size_t slot_alignment = cache_line_isolated ? std::max(alignof(T), cache_line_isolated_layout_policy::cache_line_size) : alignof(T);
+
+		// Type used to implement in place free list, smallest type able to index every slot
 		using offset_type = std::conditional_t<
-			sizeof(T) == 1,
+			(Capacity < std::numeric_limits<std::uint8_t>::max()),
 			std::uint8_t,
-			std::uint16_t
+			std::conditional_t<
+				(Capacity < std::numeric_limits<std::uint16_t>::max()),
+				std::uint16_t,
+				std::uint32_t
+			>
 		>;
 
 		static constexpr offset_type offset_type_npos = std::numeric_limits<offset_type>::max();
 		static_assert(Capacity < offset_type_npos);
 
-		alignas(alignof(T)) std::array<std::uint8_t, Capacity * sizeof(T)> storage_;
-		offset_type first_free_;
-		std::size_t size_;
+		// Free slots store the link to the next free slot in place unless the slot can't hold an offset_type,
+		// then links are kept in a separate array
+		static constexpr bool inplace_links = sizeof(T) >= sizeof(offset_type) && alignof(T) >= alignof(offset_type);
+
+		struct no_links {};
+		using link_storage = std::conditional_t<inplace_links, no_links, std::array<offset_type, Capacity>>;
 
-		// MSVC doesn't properly implement [[no_unique_address]]
-		struct offset_accessor_a
+		// Slot holds a value or, while free, the link to the next free slot. Slots are unions rather than raw bytes
+		// so the list can be used in constant evaluation, where a slot must always have an active member,
+		// empty is active in slots that hold neither.
+		struct empty_slot {};
+
+		union alignas(slot_alignment) slot_type
 		{
-			offset_type offset;
+			constexpr slot_type() noexcept {}
+			constexpr ~slot_type() requires (std::is_trivially_destructible_v<T>) = default;
+			constexpr ~slot_type() {}
+
+			T value;
+			std::conditional_t<inplace_links, offset_type, no_links> link;
+			empty_slot empty;
 		};
 
-		struct offset_accessor_b
+		// Distance between neighbouring slots, equal to sizeof(T) unless slots are cache line isolated
+		static constexpr std::size_t slot_size = sizeof(slot_type);
+
+		// Occupancy bitmap, one bit per slot, set when the slot holds a value
+		using occupancy_word = std::uint64_t;
+		static constexpr std::size_t occupancy_word_bits = std::numeric_limits<occupancy_word>::digits;
+		static constexpr std::size_t occupancy_word_count = (Capacity + occupancy_word_bits - 1) / occupancy_word_bits;
+
+		// Predicate scans compare whole occupancy words when pred is one of the value comparisons above and the
+		// compared field can be loaded without running user code, bool is excluded since free slots may hold any byte
+		template<class Pred, class Proj>
+		static constexpr bool dense_scannable = []
+		{
+			if constexpr (requires { typename Pred::scan_comparison; })
+			{
+				using field = std::remove_cvref_t<std::invoke_result_t<Proj&, const T&>>;
+				return std::is_trivially_copyable_v<T> && (std::is_same_v<Proj, std::identity> || std::is_member_object_pointer_v<Proj>) &&
+					std::is_arithmetic_v<field> && !std::is_same_v<field, bool> && std::is_same_v<field, std::remove_cv_t<decltype(Pred::value)>>;
+			}
+			else
+			{
+				return false;
+			}
+		}();
+
+		// Minimum live slots in a word for the dense scan to beat visiting the live slots one by one
+#if defined(__AVX2__)
+		static constexpr std::size_t dense_scan_threshold = occupancy_word_bits / 2;
+#else
+		static constexpr std::size_t dense_scan_threshold = occupancy_word_bits * 3 / 4;
+#endif
+
+		// Generation of a slot is advanced on both emplace and erase, odd generation means the slot holds a value.
+		// A handle is therefore valid exactly when its generation is odd and matches the slot's.
+		// Generations are zeroed when their slot is first handed out, slots at or above generation_mark_ never were,
+		// so constructing a list doesn't write every generation. The mark survives clear() to keep old handles stale.
+		struct no_generations {};
+		using generation_storage = std::conditional_t<generational, std::array<std::conditional_t<generational, Generation, char>, Capacity>, no_generations>;
+		using generation_mark = std::conditional_t<generational, offset_type, no_generations>;
+
+		// Slots below high_water_mark_ that don't hold a value are linked into a chain starting at first_free_,
+		// slots at or above it were never handed out and are allocated by bumping the mark.
+		// With address_ordered_allocation_policy there is no chain and first_free_ is the lowest free slot.
+		// Header is kept in front of the storage so constructing an empty list doesn't touch the slots,
+		// with cache_line_isolated_layout_policy the storage alignment also puts the header on separate cache lines.
+		offset_type first_free_;
+		offset_type high_water_mark_;
+		std::size_t size_;
+		std::array<occupancy_word, occupancy_word_count> occupancy_;
+#if __has_cpp_attribute(msvc::no_unique_address)
+		[[msvc::no_unique_address]]
+#elif __has_cpp_attribute(no_unique_address)
+		[[no_unique_address]]
+#endif
+		generation_storage generations_;
+#if __has_cpp_attribute(msvc::no_unique_address)
+		[[msvc::no_unique_address]]
+#elif __has_cpp_attribute(no_unique_address)
+		[[no_unique_address]]
+#endif
+		generation_mark generation_mark_{};
+#if __has_cpp_attribute(msvc::no_unique_address)
+		[[msvc::no_unique_address]]
+#elif __has_cpp_attribute(no_unique_address)
+		[[no_unique_address]]
+#endif
+		link_storage links_;
+		std::array<slot_type, Capacity> storage_;
+
+		// Image written by snapshot(), in native byte order:
+		// header, occupancy words, generations below the generation mark, links and storage of the slots below the high water mark
+		struct snapshot_header
 		{
-			offset_type offset;
-			std::array<std::uint8_t, sizeof(T) - sizeof(offset_type)> padding;
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint64_t value_size;
+			std::uint64_t value_alignment;
+			std::uint64_t slot_size;
+			std::uint64_t capacity;
+			std::uint64_t generation_size;
+			std::uint64_t address_ordered;
+			std::uint64_t first_free;
+			std::uint64_t high_water_mark;
+			std::uint64_t size;
+			std::uint64_t generation_mark;
 		};
 
-		using offset_accessor = std::conditional_t<sizeof(T) == sizeof(offset_type), offset_accessor_a, offset_accessor_b>;
+		static constexpr std::uint32_t snapshot_magic = 0x4C465846; // "FXFL"
+		static constexpr std::uint32_t snapshot_version = 2;
 
 	public:
 		using value_type = T;
+		using allocation_policy = AllocationPolicy;
+		using layout_policy = LayoutPolicy;
+		using generation_type = Generation;
+		using handle_type = inplace_free_list_handle<offset_type, Generation>;
 		using reference = T&;
 		using const_reference = const T&;
 		using pointer = T*;
@@ -53,53 +278,136 @@ namespace fox
 		using size_type = std::size_t;
 		using difference_type = std::ptrdiff_t;
 
+	private:
+		// Forward iterator over live elements, empty slots are skipped using the occupancy bitmap
+		template<class U>
+		class iterator_implementation
+		{
+			template<class>
+			friend class iterator_implementation;
+
+			using list_pointer = std::conditional_t<std::is_const_v<U>, const inplace_free_list*, inplace_free_list*>;
+
+			// Current occupancy word and its not yet visited bits
+			list_pointer list_ = nullptr;
+			std::size_t word_ = occupancy_word_count;
+			occupancy_word bits_ = {};
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using iterator_concept = std::forward_iterator_tag;
+			using difference_type = std::ptrdiff_t;
+			using value_type = std::remove_const_t<U>;
+			using reference = U&;
+			using pointer = U*;
+
+		public:
+			iterator_implementation() = default;
+
+			constexpr iterator_implementation(list_pointer list, std::size_t word) noexcept
+				: list_(list), word_(word)
+			{
+				if (word_ != occupancy_word_count)
+				{
+					bits_ = list_->occupancy_[word_];
+					skip_empty_words();
+				}
+			}
+
+			template<class V>
+			constexpr iterator_implementation(const iterator_implementation<V>& other) noexcept
+				requires(std::is_const_v<U> && !std::is_const_v<V>)
+				: list_(other.list_), word_(other.word_), bits_(other.bits_) {}
+
+		public:
+			[[nodiscard]] constexpr reference operator*() const noexcept
+			{
+				return *operator->();
+			}
+
+			[[nodiscard]] constexpr pointer operator->() const noexcept
+			{
+				return list_->slot(word_ * occupancy_word_bits + static_cast<std::size_t>(std::countr_zero(bits_)));
+			}
+
+			constexpr iterator_implementation& operator++() noexcept
+			{
+				bits_ &= bits_ - 1;
+				skip_empty_words();
+				return *this;
+			}
+
+			[[nodiscard]] constexpr iterator_implementation operator++(int) noexcept
+			{
+				auto it = *this;
+				++(*this);
+				return it;
+			}
+
+			[[nodiscard]] friend constexpr bool operator==(const iterator_implementation& lhs, const iterator_implementation& rhs) noexcept
+			{
+				return lhs.word_ == rhs.word_ && lhs.bits_ == rhs.bits_;
+			}
+
+		private:
+			constexpr void skip_empty_words() noexcept
+			{
+				while (bits_ == 0 && ++word_ != occupancy_word_count)
+					bits_ = list_->occupancy_[word_];
+			}
+		};
+
+	public:
+		using iterator = iterator_implementation<T>;
+		using const_iterator = iterator_implementation<const T>;
+
 	public:
-		inplace_free_list()
+		constexpr inplace_free_list()
 		{
 			initialize_empty();
 		}
 
-		inplace_free_list(const inplace_free_list& other)
+		constexpr inplace_free_list(const inplace_free_list& other)
 		{
 			initialize_copy(other);
 		}
 
 		template<class U, class TransformFunc>
-		inplace_free_list(const inplace_free_list<U, Capacity>& other, TransformFunc&& func)
+		constexpr inplace_free_list(const inplace_free_list<U, Capacity, AllocationPolicy, Generation, LayoutPolicy>& other, TransformFunc&& func)
 			requires (std::is_invocable_r_v<T, TransformFunc, const U&>)
 		{
 			initialize_transform(other, std::forward<TransformFunc>(func));
 		}
 
-		inplace_free_list(inplace_free_list&& other) noexcept
+		constexpr inplace_free_list(inplace_free_list&& other) noexcept
 		{
 			initialize_move(other);
-			other.initialize_empty();
+			other.clear();
 		}
 
-		inplace_free_list& operator=(const inplace_free_list& other)
+		constexpr inplace_free_list& operator=(const inplace_free_list& other)
 		{
 			destroy_all();
 			initialize_copy(other);
 			return *this;
 		}
 
-		inplace_free_list& operator=(inplace_free_list&& other) noexcept
+		constexpr inplace_free_list& operator=(inplace_free_list&& other) noexcept
 		{
 			destroy_all();
 			initialize_move(other);
-			other.initialize_empty();
+			other.clear();
 			return *this;
 		}
 
-		~inplace_free_list()
+		constexpr ~inplace_free_list()
 		{
 			destroy_all();
 		}
 
 	public:
 		template<class U, class TransformFunc>
-		void assign(const inplace_free_list<U, Capacity>& other, TransformFunc&& func)
+		constexpr void assign(const inplace_free_list<U, Capacity, AllocationPolicy, Generation, LayoutPolicy>& other, TransformFunc&& func)
 			requires (std::is_invocable_r_v<T, TransformFunc, const U&>)
 		{
 			destroy_all();
@@ -112,291 +420,1213 @@ namespace fox
 			return Capacity;
 		}
 
-		[[nodiscard]] size_type size() const noexcept
+		[[nodiscard]] constexpr size_type size() const noexcept
 		{
 			return size_;
 		}
 
-		[[nodiscard]] bool empty() const noexcept
+		[[nodiscard]] constexpr bool empty() const noexcept
 		{
 			return size() == 0;
 		}
 
-		[[nodiscard]] bool full() const noexcept
+		[[nodiscard]] constexpr bool full() const noexcept
 		{
-			return first_free_ == offset_type_npos;
+			return size_ == Capacity;
 		}
 
 	public:
-		void clear() noexcept
+		[[nodiscard]] constexpr iterator begin() noexcept
 		{
-			destroy_all();
-			initialize_empty();
+			return iterator(this, 0);
 		}
 
-		[[nodiscard]] std::bitset<Capacity> free_mask() const noexcept
+		[[nodiscard]] constexpr const_iterator begin() const noexcept
 		{
-			std::bitset<Capacity> out;
-			const offset_accessor* begin = reinterpret_cast<const offset_accessor*>(std::data(storage_));
-
-			for(offset_type i = first_free_; i != offset_type_npos; i = begin[i].offset)
-			{
-				out.set(i);
-			}
-
-			return out;
+			return const_iterator(this, 0);
 		}
 
-	public:
-		template<class... Args>
-		[[nodiscard]] T* emplace(Args&&... args) requires (std::constructible_from<T, Args...>)
+		[[nodiscard]] constexpr const_iterator cbegin() const noexcept
 		{
-			if (first_free_ == offset_type_npos)
-				return nullptr;
-
-			T* out = reinterpret_cast<T*>(std::data(storage_)) + first_free_;
-			first_free_ = reinterpret_cast<offset_accessor*>(std::data(storage_))[first_free_].offset;
-
-			std::construct_at(out, std::forward<Args>(args)...);
-			size_ = size_ + 1;
-			return out;
+			return this->begin();
 		}
 
-		[[nodiscard]] T* insert(const T& value) requires (std::is_copy_constructible_v<T>)
+		[[nodiscard]] constexpr iterator end() noexcept
 		{
-			return emplace(value);
+			return iterator(this, occupancy_word_count);
 		}
 
-		[[nodiscard]] T* insert(T&& value) requires (std::is_copy_constructible_v<T>)
+		[[nodiscard]] constexpr const_iterator end() const noexcept
 		{
-			return emplace(std::forward<T&&>(value));
+			return const_iterator(this, occupancy_word_count);
 		}
 
-	public:
-		void erase(const T* ptr) noexcept
+		[[nodiscard]] constexpr const_iterator cend() const noexcept
 		{
-			assert_holds_value(ptr);
-
-			std::destroy_at(const_cast<T*>(ptr));
-			offset_accessor* p_offset_accessor = std::bit_cast<offset_accessor*>(ptr);
-			std::construct_at(p_offset_accessor, first_free_);
-			first_free_ = static_cast<offset_type>(std::bit_cast<std::ptrdiff_t>(p_offset_accessor - reinterpret_cast<offset_accessor*>(std::data(storage_))));
-			size_ = size_ - 1;
+			return this->end();
 		}
 
-	public:
-		[[nodiscard]] T* data() noexcept
+		// Invokes func on every live element, cheaper than iterating with begin() / end()
+		template<class Func>
+		constexpr void for_each_live(Func&& func) requires (std::is_invocable_v<Func&, T&>)
 		{
-			return reinterpret_cast<T*>(std::data(storage_));
+			for_each_occupied_index([&](std::size_t i) { func(*slot(i)); });
 		}
 
-		[[nodiscard]] const T* data() const noexcept
+		template<class Func>
+		constexpr void for_each_live(Func&& func) const requires (std::is_invocable_v<Func&, const T&>)
 		{
-			return reinterpret_cast<const T*>(std::data(storage_));
+			for_each_occupied_index([&](std::size_t i) { func(*slot(i)); });
 		}
 
-		[[nodiscard]] bool owns(const T* ptr) const noexcept
+		// Predicate scans over live elements, pred is invoked once on std::invoke(proj, element) for every live element.
+		// equal_to_value, less_than_value and greater_than_value on an arithmetic field are evaluated with vector
+		// compares instead, free slots are compared too and their results discarded.
+		template<class Pred, class Proj = std::identity>
+		[[nodiscard]] constexpr T* find_if(Pred pred, Proj proj = {}) requires (std::is_invocable_v<Proj&, const T&>)
 		{
-			return
-				std::data(storage_) <= reinterpret_cast<const std::uint8_t*>(ptr) &&
-				reinterpret_cast<const std::uint8_t*>(ptr) < std::data(storage_) + std::size(storage_);
+			return const_cast<T*>(std::as_const(*this).find_if(std::move(pred), std::move(proj)));
 		}
 
-		[[nodiscard]] bool holds_value(const T* ptr) const noexcept
+		template<class Pred, class Proj = std::identity>
+		[[nodiscard]] constexpr const T* find_if(Pred pred, Proj proj = {}) const requires (std::is_invocable_v<Proj&, const T&>)
 		{
-			return !free_mask().test(as_index(ptr));
+			const T* out = nullptr;
+			scan_matches(pred, proj, [&](std::size_t base, occupancy_word matches)
+			{
+				if (matches == 0)
+					return true;
+
+				out = slot(base + static_cast<std::size_t>(std::countr_zero(matches)));
+				return false;
+			});
+
+			return out;
 		}
 
-		[[nodiscard]] size_type as_index(const T* ptr) const noexcept
+		template<class Pred, class Proj = std::identity>
+		[[nodiscard]] constexpr size_type count_if(Pred pred, Proj proj = {}) const requires (std::is_invocable_v<Proj&, const T&>)
 		{
-			assert_own(ptr);
+			size_type out{};
+			scan_matches(pred, proj, [&](std::size_t, occupancy_word matches)
+			{
+				out += static_cast<size_type>(std::popcount(matches));
+				return true;
+			});
 
-			return static_cast<std::size_t>(ptr - data());
+			return out;
 		}
 
-	public:
-		[[nodiscard]] const T* operator[](size_type idx) const noexcept
+		template<class Pred, class Func, class Proj = std::identity>
+		constexpr void for_each_live_if(Pred pred, Func&& func, Proj proj = {}) requires (std::is_invocable_v<Proj&, const T&> && std::is_invocable_v<Func&, T&>)
 		{
-			auto ptr = this->data() + idx;
-			assert_holds_value(ptr);
-			return ptr;
+			scan_matches(pred, proj, [&](std::size_t base, occupancy_word matches)
+			{
+				for (; matches != 0; matches &= matches - 1)
+					func(*slot(base + static_cast<std::size_t>(std::countr_zero(matches))));
+
+				return true;
+			});
 		}
 
-		[[nodiscard]] T* operator[](size_type idx) noexcept
+		template<class Pred, class Func, class Proj = std::identity>
+		constexpr void for_each_live_if(Pred pred, Func&& func, Proj proj = {}) const requires (std::is_invocable_v<Proj&, const T&> && std::is_invocable_v<Func&, const T&>)
 		{
-			auto ptr = this->data() + idx;
-			assert_holds_value(ptr);
-			return ptr;
+			scan_matches(pred, proj, [&](std::size_t base, occupancy_word matches)
+			{
+				for (; matches != 0; matches &= matches - 1)
+					func(*slot(base + static_cast<std::size_t>(std::countr_zero(matches))));
+
+				return true;
+			});
 		}
 
-		[[nodiscard]] bool holds_value_at(size_type idx) const noexcept
+	public:
+		constexpr void clear() noexcept
 		{
-			assert_own(this->data() + idx);
-			return !free_mask().test(idx);
+			destroy_all();
+			initialize_empty();
 		}
 
-		[[nodiscard]] const T* at(size_type idx) const
+		[[nodiscard]] std::bitset<Capacity> free_mask() const noexcept
 		{
-			auto ptr = this->data() + idx;
-
-			if (!owns(ptr))
-				throw std::out_of_range("Index is out of range.");
+			std::bitset<Capacity> out;
+			out.set();
 
-			if (!holds_value(ptr))
-				throw std::out_of_range("Index doesn't hold value.");
+			for_each_occupied_index([&](std::size_t i) { out.reset(i); });
 
-			return ptr;
+			return out;
 		}
 
-		[[nodiscard]] T* at(size_type idx)
+	public:
+		template<class... Args>
+		[[nodiscard]] constexpr T* emplace(Args&&... args) requires (std::constructible_from<T, Args...>)
 		{
-			auto ptr = this->data() + idx;
+			const offset_type idx = acquire_slot();
+			if (idx == offset_type_npos)
+				return nullptr;
 
-			if (!owns(ptr))
-				throw std::out_of_range("Index is out of range.");
+			T* out = slot(idx);
 
-			if (!holds_value(ptr))
-				throw std::out_of_range("Index doesn't hold value.");
+			try
+			{
+				std::construct_at(out, std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				release_slot(idx);
+				std::rethrow_exception(std::current_exception());
+			}
 
-			return ptr;
+			advance_generation(idx);
+			size_ = size_ + 1;
+			return out;
 		}
 
-	private:
-		void assert_own([[maybe_unused]] const T* ptr) const
+		template<class... Args>
+		[[nodiscard]] constexpr handle_type emplace_handle(Args&&... args) requires (generational && std::constructible_from<T, Args...>)
 		{
-			assert(this->owns(ptr) == true && "inplace_free_list<T> doesn't own this pointer.");
+			T* ptr = emplace(std::forward<Args>(args)...);
+			if (ptr == nullptr)
+				return handle_type{ offset_type_npos, Generation{} };
+
+			return this->get_handle(ptr);
 		}
 
-		void assert_holds_value([[maybe_unused]] const T* ptr) const noexcept
+		[[nodiscard]] constexpr T* insert(const T& value) requires (std::is_copy_constructible_v<T>)
 		{
-			assert(this->holds_value(ptr) == true && "inplace_free_list<T> ptr doesn't hold value.");
+			return emplace(value);
 		}
 
-		void destroy_all()
+		[[nodiscard]] constexpr T* insert(T&& value) requires (std::is_copy_constructible_v<T>)
 		{
-			auto mask = free_mask();
-			T* begin = reinterpret_cast<T*>(std::data(storage_));
-			for (std::size_t i{}; i < std::size(mask); ++i)
-			{
-				if(mask.test(i) == false)
-					std::destroy_at(begin + i);
-			}
+			return emplace(std::forward<T&&>(value));
 		}
 
-		void initialize_copy(const inplace_free_list& other)
+		// Emplaces min(count, capacity() - size()) values constructed from args and writes pointers to them to out.
+		// Values constructed before an exception stay in the list, including one whose pointer couldn't be written to out.
+		template<std::output_iterator<T*> OutputIt, class... Args>
+		constexpr OutputIt emplace_n(size_type count, OutputIt out, const Args&... args) requires (std::constructible_from<T, const Args&...>)
 		{
-			first_free_ = other.first_free_;
-			size_ = other.size_;
+			const size_type n = std::min(count, Capacity - size_);
 
-			if constexpr (std::is_trivially_copy_constructible_v<T>)
-			{
-				storage_ = other.storage_;
-			}
-			else
+			for (size_type constructed{}; constructed < n; ++constructed)
 			{
-				std::bitset<Capacity> mask;
-				const offset_accessor* other_begin = reinterpret_cast<const offset_accessor*>(std::data(other.storage_));
-				offset_accessor* begin = reinterpret_cast<offset_accessor*>(std::data(storage_));
+				const offset_type idx = acquire_slot();
 
-				for (offset_type i = first_free_; i != offset_type_npos; i = other_begin[i].offset)
+				T* ptr;
+				try
+				{
+					ptr = std::construct_at(slot(idx), args...);
+				}
+				catch (...)
 				{
-					mask.set(i);
-					std::construct_at(begin + i, other_begin[i]);
+					release_slot(idx);
+					size_ = size_ + constructed;
+					throw;
 				}
 
-				for (std::size_t i{}; i < std::size(mask); ++i)
+				advance_generation(idx);
+
+				try
 				{
-					if (mask.test(i) == false)
-					{
-						std::construct_at(
-							reinterpret_cast<T*>(begin + i),
-							*reinterpret_cast<const T*>(other_begin + i)
-						);
-					}
+					*out = ptr;
+					++out;
+				}
+				catch (...)
+				{
+					size_ = size_ + constructed + 1;
+					throw;
 				}
 			}
+
+			size_ = size_ + n;
+			return out;
 		}
 
-		template<class U, class Func>
-		void initialize_transform(const inplace_free_list<U, Capacity>& other, Func&& func)
+	public:
+		constexpr void erase(const T* ptr) noexcept
 		{
-			using other_offset_accessor = const typename inplace_free_list<U, Capacity>::offset_accessor;
+			assert_holds_value(ptr);
 
-			first_free_ = other.first_free_;
-			size_ = other.size_;
+			const auto idx = static_cast<offset_type>(as_index(ptr));
+			destroy_slot(idx);
+			advance_generation(idx);
+			release_slot(idx);
+			size_ = size_ - 1;
+		}
 
-			std::bitset<Capacity> mask;
-			const other_offset_accessor* other_begin = reinterpret_cast<const other_offset_accessor*>(std::data(other.storage_));
-			offset_accessor* begin = reinterpret_cast<offset_accessor*>(std::data(storage_));
+		constexpr void erase(handle_type handle) noexcept requires (generational)
+		{
+			assert(this->holds_value(handle) == true && "inplace_free_list<T> handle is stale.");
+			erase(slot(handle.index));
+		}
 
-			for (offset_type i = first_free_; i != offset_type_npos; i = other_begin[i].offset)
+		// Erases every value pointed to by the range. With lifo_allocation_policy each freed slot is pushed onto
+		// the head of the free chain, so the slots are reused in reverse range order.
+		template<std::ranges::input_range R>
+		constexpr void erase_n(R&& pointers) noexcept requires (std::convertible_to<std::ranges::range_reference_t<R>, const T*>)
+		{
+			size_type erased{};
+			for (const T* ptr : pointers)
 			{
-				mask.set(i);
-				std::construct_at(begin + i, *reinterpret_cast<const offset_accessor*>(other_begin + i));
+				assert_holds_value(ptr);
+
+				const auto idx = static_cast<offset_type>(as_index(ptr));
+				destroy_slot(idx);
+				advance_generation(idx);
+				release_slot(idx);
+				++erased;
 			}
 
-			for (std::size_t i{}; i < std::size(mask); ++i)
+			size_ = size_ - erased;
+		}
+
+	public:
+		// Moves live values into the lowest slots so free slots form one contiguous tail.
+		// relocate(old, new) is invoked after each move, old no longer holds a value at that point.
+		template<class RelocateFn>
+		constexpr void compact(RelocateFn&& relocate) requires (std::is_move_constructible_v<T> && std::is_invocable_v<RelocateFn&, T*, T*>)
+		{
+			std::size_t to = next_free_index(0);
+			std::size_t from = previous_occupied_index(high_water_mark_);
+
+			try
 			{
-				if (mask.test(i) == false)
+				for (; to != offset_type_npos && from != Capacity && to < from; )
 				{
-					std::construct_at(
-						reinterpret_cast<T*>(begin + i),
-						func(*reinterpret_cast<const U*>(other_begin + i))
-					);
+					std::construct_at(slot(to), std::move(*slot(from)));
+					destroy_slot(from);
+
+					mark_occupied(to);
+					advance_generation(to);
+					mark_free(from);
+					advance_generation(from);
+
+					relocate(slot(from), slot(to));
+
+					to = next_free_index(to + 1);
+					from = previous_occupied_index(from);
 				}
 			}
+			catch (...)
+			{
+				// Moved values overwrote links of the slots they were moved into
+				if constexpr (address_ordered)
+					first_free_ = next_free_index(0);
+				else
+					rebuild_free_chain();
+
+				std::rethrow_exception(std::current_exception());
+			}
+
+			high_water_mark_ = static_cast<offset_type>(size_);
+			first_free_ = address_ordered && size_ != Capacity ? static_cast<offset_type>(size_) : offset_type_npos;
 		}
 
-		void initialize_move(inplace_free_list& other) noexcept
+		constexpr void compact() requires (std::is_move_constructible_v<T>)
 		{
-			first_free_ = other.first_free_;
-			size_ = other.size_;
+			compact([](T*, T*) {});
+		}
+
+	public:
+		// Size in bytes of the image snapshot() writes
+		[[nodiscard]] size_type snapshot_size() const noexcept
+		{
+			return snapshot_size(high_water_mark_, snapshot_generation_mark());
+		}
 
-			if constexpr (std::is_trivially_copy_constructible_v<T>)
+		// Writes a flat image of the list, restoring it gives back the values at the same indices
+		template<std::output_iterator<std::uint8_t> OutputIt>
+		OutputIt snapshot(OutputIt out) const requires (std::is_trivially_copyable_v<T>)
+		{
+			const snapshot_header header{
+				snapshot_magic,
+				snapshot_version,
+				sizeof(T),
+				alignof(T),
+				slot_size,
+				Capacity,
+				snapshot_generation_size(),
+				address_ordered,
+				first_free_,
+				high_water_mark_,
+				size_,
+				snapshot_generation_mark()
+			};
+
+			out = write_bytes(std::addressof(header), sizeof(header), std::move(out));
+			out = write_bytes(std::data(occupancy_), sizeof(occupancy_), std::move(out));
+
+			if constexpr (generational)
 			{
-				storage_ = std::move(other.storage_);
+				out = write_bytes(std::data(generations_), generation_mark_ * sizeof(Generation), std::move(out));
 			}
-			else
+
+			if constexpr (!inplace_links)
 			{
-				std::bitset<Capacity> mask;
-				offset_accessor* other_begin = reinterpret_cast<offset_accessor*>(std::data(other.storage_));
-				offset_accessor* begin = reinterpret_cast<offset_accessor*>(std::data(storage_));
+				out = write_bytes(std::data(links_), high_water_mark_ * sizeof(offset_type), std::move(out));
+			}
 
-				for (offset_type i = first_free_; i != offset_type_npos; i = other_begin[i].offset)
-				{
-					mask.set(i);
-					std::construct_at(begin + i, other_begin[i]);
-				}
+			return write_bytes(std::data(storage_), high_water_mark_ * slot_size, std::move(out));
+		}
 
-				for (std::size_t i{}; i < std::size(mask); ++i)
-				{
-					if (mask.test(i) == false)
-					{
-						std::construct_at(
-							reinterpret_cast<T*>(begin + i),
-							std::move(*reinterpret_cast<T*>(other_begin + i))
-						);
-					}
-				}
+		// Replaces the contents with an image written by snapshot() of a list of the same type. image may continue
+		// past the snapshot and doesn't have to be aligned, so it can be read straight from a mapped file.
+		// Returns the number of bytes read, throws std::invalid_argument and leaves the list unchanged when image isn't valid.
+		size_type restore(std::span<const std::uint8_t> image) requires (std::is_trivially_copyable_v<T>)
+		{
+			snapshot_header header;
+			if (std::size(image) < sizeof(header))
+				throw std::invalid_argument("inplace_free_list<T> snapshot is truncated.");
+
+			std::memcpy(std::addressof(header), std::data(image), sizeof(header));
+
+			if (header.magic != snapshot_magic || header.version != snapshot_version)
+				throw std::invalid_argument("inplace_free_list<T> snapshot has unknown format.");
+
+			if (header.value_size != sizeof(T) || header.value_alignment != alignof(T) || header.slot_size != slot_size ||
+				header.capacity != Capacity || header.generation_size != snapshot_generation_size() || header.address_ordered != address_ordered)
+				throw std::invalid_argument("inplace_free_list<T> snapshot was written by a different type.");
+
+			if (header.high_water_mark > Capacity || header.size > header.high_water_mark ||
+				(header.first_free >= Capacity && header.first_free != offset_type_npos) ||
+				(generational ? header.generation_mark < header.high_water_mark || header.generation_mark > Capacity : header.generation_mark != 0))
+				throw std::invalid_argument("inplace_free_list<T> snapshot is corrupted.");
+
+			const auto high_water_mark = static_cast<offset_type>(header.high_water_mark);
+			const auto mark = static_cast<std::size_t>(header.generation_mark);
+			const size_type image_size = snapshot_size(high_water_mark, mark);
+			if (std::size(image) < image_size)
+				throw std::invalid_argument("inplace_free_list<T> snapshot is truncated.");
+
+			const std::uint8_t* occupancy_in = std::data(image) + sizeof(header);
+			const std::uint8_t* generations_in = occupancy_in + sizeof(occupancy_);
+			const std::uint8_t* links_in = generations_in + mark * snapshot_generation_size();
+			const std::uint8_t* storage_in = links_in + (inplace_links ? 0 : high_water_mark * sizeof(offset_type));
+
+			decltype(occupancy_) occupancy;
+			std::memcpy(std::data(occupancy), occupancy_in, sizeof(occupancy));
+
+			if (!valid_snapshot_state(header, occupancy, generations_in, links_in, storage_in))
+				throw std::invalid_argument("inplace_free_list<T> snapshot is corrupted.");
+
+			first_free_ = static_cast<offset_type>(header.first_free);
+			high_water_mark_ = high_water_mark;
+			size_ = static_cast<std::size_t>(header.size);
+			occupancy_ = occupancy;
+
+			if constexpr (generational)
+			{
+				generation_mark_ = static_cast<offset_type>(mark);
+				std::memcpy(std::data(generations_), generations_in, mark * sizeof(Generation));
+			}
+
+			if constexpr (!inplace_links)
+			{
+				std::memcpy(std::data(links_), links_in, high_water_mark_ * sizeof(offset_type));
 			}
+
+			std::memcpy(std::data(storage_), storage_in, high_water_mark_ * slot_size);
+
+			return image_size;
 		}
 
-		void initialize_empty()
+	public:
+		// Slot idx is at data() + idx only with packed_layout_policy
+		[[nodiscard]] constexpr T* data() noexcept
 		{
-			size_ = {};
-			first_free_ = {};
-			offset_type i = {};
-			for (offset_accessor*
-				begin = reinterpret_cast<offset_accessor*>(std::data(storage_)),
-				*end = begin + Capacity;
-				begin != end;
-				++begin
-				)
+			return slot(0);
+		}
+
+		[[nodiscard]] constexpr const T* data() const noexcept
+		{
+			return slot(0);
+		}
+
+		[[nodiscard]] constexpr bool owns(const T* ptr) const noexcept
+		{
+			// Pointers into different slots can't be ordered in constant evaluation
+			if consteval
 			{
-				std::construct_at(begin, ++i);
+				return find_slot(ptr) != Capacity;
 			}
+			else
+			{
+				const auto first = reinterpret_cast<const std::uint8_t*>(std::data(storage_));
+				return first <= reinterpret_cast<const std::uint8_t*>(ptr) && reinterpret_cast<const std::uint8_t*>(ptr) < first + sizeof(storage_);
+			}
+		}
 
-			reinterpret_cast<offset_accessor*>(std::data(storage_))[Capacity - 1].offset = offset_type_npos;
+		[[nodiscard]] constexpr bool holds_value(const T* ptr) const noexcept
+		{
+			// Pointers into the padding of a cache line isolated slot don't point to its value
+			const std::size_t idx = as_index(ptr);
+			return occupied(idx) && (slot_size == sizeof(T) || slot(idx) == ptr);
 		}
-	};
+
+		[[nodiscard]] constexpr bool holds_value(handle_type handle) const noexcept requires (generational)
+		{
+			// Even generations never refer to a value, a value initialized handle would otherwise match an unused slot
+			return (handle.generation & 1u) != 0 && handle.index < generation_mark_ && generations_[handle.index] == handle.generation;
+		}
+
+		[[nodiscard]] constexpr handle_type get_handle(const T* ptr) const noexcept requires (generational)
+		{
+			assert_holds_value(ptr);
+
+			const auto idx = static_cast<offset_type>(as_index(ptr));
+			return handle_type{ idx, generations_[idx] };
+		}
+
+		// Returns nullptr when the handle's slot was erased or reused since the handle was created
+		[[nodiscard]] constexpr T* try_get(handle_type handle) noexcept requires (generational)
+		{
+			return holds_value(handle) ? slot(handle.index) : nullptr;
+		}
+
+		[[nodiscard]] constexpr const T* try_get(handle_type handle) const noexcept requires (generational)
+		{
+			return holds_value(handle) ? slot(handle.index) : nullptr;
+		}
+
+		[[nodiscard]] constexpr size_type as_index(const T* ptr) const noexcept
+		{
+			assert_own(ptr);
+
+			if consteval
+			{
+				return find_slot(ptr);
+			}
+			else
+			{
+				if constexpr (slot_size == sizeof(T))
+					return static_cast<std::size_t>(ptr - data());
+				else
+					return static_cast<std::size_t>(reinterpret_cast<const std::uint8_t*>(ptr) - reinterpret_cast<const std::uint8_t*>(std::data(storage_))) / slot_size;
+			}
+		}
+
+	public:
+		[[nodiscard]] constexpr const T* operator[](size_type idx) const noexcept
+		{
+			auto ptr = slot(idx);
+			assert_holds_value(ptr);
+			return ptr;
+		}
+
+		[[nodiscard]] constexpr T* operator[](size_type idx) noexcept
+		{
+			auto ptr = slot(idx);
+			assert_holds_value(ptr);
+			return ptr;
+		}
+
+		[[nodiscard]] constexpr bool holds_value_at(size_type idx) const noexcept
+		{
+			assert(idx < Capacity && "inplace_free_list<T> doesn't own this index.");
+			return occupied(idx);
+		}
+
+		[[nodiscard]] constexpr const T* at(size_type idx) const
+		{
+			if (idx >= Capacity)
+				throw std::out_of_range("Index is out of range.");
+
+			auto ptr = slot(idx);
+
+			if (!holds_value(ptr))
+				throw std::out_of_range("Index doesn't hold value.");
+
+			return ptr;
+		}
+
+		[[nodiscard]] constexpr T* at(size_type idx)
+		{
+			if (idx >= Capacity)
+				throw std::out_of_range("Index is out of range.");
+
+			auto ptr = slot(idx);
+
+			if (!holds_value(ptr))
+				throw std::out_of_range("Index doesn't hold value.");
+
+			return ptr;
+		}
+
+	private:
+		constexpr void assert_own([[maybe_unused]] const T* ptr) const
+		{
+			assert(this->owns(ptr) == true && "inplace_free_list<T> doesn't own this pointer.");
+		}
+
+		constexpr void assert_holds_value([[maybe_unused]] const T* ptr) const noexcept
+		{
+			assert(this->holds_value(ptr) == true && "inplace_free_list<T> ptr doesn't hold value.");
+		}
+
+		[[nodiscard]] static constexpr std::uint64_t snapshot_generation_size() noexcept
+		{
+			if constexpr (generational)
+				return sizeof(Generation);
+			else
+				return 0;
+		}
+
+		[[nodiscard]] constexpr std::uint64_t snapshot_generation_mark() const noexcept
+		{
+			if constexpr (generational)
+				return generation_mark_;
+			else
+				return 0;
+		}
+
+		[[nodiscard]] static constexpr size_type snapshot_size(std::size_t high_water_mark, std::size_t generation_mark) noexcept
+		{
+			size_type out = sizeof(snapshot_header) + sizeof(occupancy_) + high_water_mark * slot_size + generation_mark * snapshot_generation_size();
+
+			if constexpr (!inplace_links)
+				out += high_water_mark * sizeof(offset_type);
+
+			return out;
+		}
+
+		// Checks that the occupancy, generations and free slots of an image describe a list this type could have
+		// reached, so no later operation touches a slot at or above the high water mark or hands out a live slot
+		[[nodiscard]] static bool valid_snapshot_state(const snapshot_header& header, const decltype(occupancy_)& occupancy,
+			const std::uint8_t* generations_in, const std::uint8_t* links_in, const std::uint8_t* storage_in) noexcept
+		{
+			const auto high_water_mark = static_cast<std::size_t>(header.high_water_mark);
+
+			auto is_occupied = [&](std::size_t idx)
+			{
+				return ((occupancy[idx / occupancy_word_bits] >> (idx % occupancy_word_bits)) & occupancy_word{ 1 }) != 0;
+			};
+
+			std::size_t live{};
+			for (std::size_t w{}; w < occupancy_word_count; ++w)
+			{
+				// Only slots below the high water mark may hold a value
+				occupancy_word beyond = ~occupancy_word{};
+				if (const std::size_t base = w * occupancy_word_bits; high_water_mark > base)
+					beyond = high_water_mark - base >= occupancy_word_bits ? occupancy_word{} : ~occupancy_word{} << (high_water_mark - base);
+
+				if ((occupancy[w] & beyond) != 0)
+					return false;
+
+				live += static_cast<std::size_t>(std::popcount(occupancy[w]));
+			}
+
+			if (live != header.size)
+				return false;
+
+			if constexpr (generational)
+			{
+				// Odd generation means the slot holds a value, slots at or above the mark are free
+				for (std::size_t i{}; i < header.generation_mark; ++i)
+				{
+					Generation generation;
+					std::memcpy(std::addressof(generation), generations_in + i * sizeof(Generation), sizeof(Generation));
+
+					if (((generation & 1u) != 0) != is_occupied(i))
+						return false;
+				}
+			}
+
+			if constexpr (address_ordered)
+			{
+				// There is no chain, first_free_ has to be the lowest free slot
+				std::size_t lowest_free{};
+				while (lowest_free < Capacity && is_occupied(lowest_free))
+					++lowest_free;
+
+				return header.first_free == (lowest_free == Capacity ? offset_type_npos : lowest_free);
+			}
+			else
+			{
+				// The chain has to visit every free slot below the high water mark exactly once. Links only depend
+				// on the slot, so visiting a slot twice is a cycle and runs out of free slots before reaching the end.
+				std::size_t remaining = high_water_mark - live;
+
+				for (std::uint64_t idx = header.first_free; idx != offset_type_npos; --remaining)
+				{
+					if (idx >= high_water_mark || remaining == 0 || is_occupied(static_cast<std::size_t>(idx)))
+						return false;
+
+					offset_type next;
+					if constexpr (inplace_links)
+						std::memcpy(std::addressof(next), storage_in + idx * slot_size, sizeof(offset_type));
+					else
+						std::memcpy(std::addressof(next), links_in + idx * sizeof(offset_type), sizeof(offset_type));
+
+					idx = next;
+				}
+
+				return remaining == 0;
+			}
+		}
+
+		template<class OutputIt>
+		[[nodiscard]] static OutputIt write_bytes(const void* from, std::size_t count, OutputIt out)
+		{
+			const auto bytes = static_cast<const std::uint8_t*>(from);
+			return std::copy(bytes, bytes + count, std::move(out));
+		}
+
+		[[nodiscard]] constexpr T* slot(std::size_t idx) noexcept
+		{
+			return std::addressof(storage_[idx].value);
+		}
+
+		[[nodiscard]] constexpr const T* slot(std::size_t idx) const noexcept
+		{
+			return std::addressof(storage_[idx].value);
+		}
+
+		// Index of the slot ptr points to by comparing against every slot, Capacity if there is none
+		[[nodiscard]] constexpr std::size_t find_slot(const T* ptr) const noexcept
+		{
+			for (std::size_t i{}; i < Capacity; ++i)
+			{
+				if (slot(i) == ptr)
+					return i;
+			}
+
+			return Capacity;
+		}
+
+		constexpr void destroy_slot(std::size_t idx) noexcept
+		{
+			std::destroy_at(slot(idx));
+
+			if consteval
+			{
+				std::construct_at(std::addressof(storage_[idx].empty));
+			}
+		}
+
+		// In constant evaluation every slot has to have an active member and links and generations have to be initialized
+		constexpr void initialize_slots() noexcept
+		{
+			if consteval
+			{
+				for (slot_type& s : storage_)
+					std::construct_at(std::addressof(s.empty));
+
+				if constexpr (!inplace_links)
+				{
+					links_ = {};
+				}
+
+				if constexpr (generational)
+				{
+					std::fill(std::begin(generations_) + generation_mark_, std::end(generations_), Generation{});
+				}
+			}
+		}
+
+		[[nodiscard]] constexpr bool occupied(std::size_t idx) const noexcept
+		{
+			return (occupancy_[idx / occupancy_word_bits] >> (idx % occupancy_word_bits)) & occupancy_word{ 1 };
+		}
+
+		constexpr void mark_occupied(std::size_t idx) noexcept
+		{
+			occupancy_[idx / occupancy_word_bits] |= occupancy_word{ 1 } << (idx % occupancy_word_bits);
+		}
+
+		constexpr void mark_free(std::size_t idx) noexcept
+		{
+			occupancy_[idx / occupancy_word_bits] &= ~(occupancy_word{ 1 } << (idx % occupancy_word_bits));
+		}
+
+		// Takes a free slot according to the allocation policy, returns offset_type_npos when full
+		[[nodiscard]] constexpr offset_type acquire_slot() noexcept
+		{
+			if constexpr (address_ordered)
+			{
+				const offset_type idx = first_free_;
+				if (idx == offset_type_npos)
+					return offset_type_npos;
+
+				mark_occupied(idx);
+				first_free_ = next_free_index(idx + 1);
+				high_water_mark_ = std::max(high_water_mark_, static_cast<offset_type>(idx + 1));
+				initialize_generation(idx);
+				return idx;
+			}
+			else
+			{
+				offset_type idx;
+				if (first_free_ != offset_type_npos)
+				{
+					idx = first_free_;
+					first_free_ = next_link(idx);
+				}
+				else if (high_water_mark_ != Capacity)
+				{
+					idx = high_water_mark_;
+					high_water_mark_ = static_cast<offset_type>(high_water_mark_ + 1);
+				}
+				else
+				{
+					return offset_type_npos;
+				}
+
+				mark_occupied(idx);
+				initialize_generation(idx);
+				return idx;
+			}
+		}
+
+		// Returns a slot whose value was already destroyed to the free slots
+		constexpr void release_slot(offset_type idx) noexcept
+		{
+			mark_free(idx);
+
+			if constexpr (address_ordered)
+			{
+				first_free_ = std::min(first_free_, idx);
+			}
+			else
+			{
+				set_link(idx, first_free_);
+				first_free_ = idx;
+			}
+		}
+
+		[[nodiscard]] constexpr offset_type next_link(std::size_t idx) const noexcept
+		{
+			if constexpr (inplace_links)
+			{
+				return storage_[idx].link;
+			}
+			else
+			{
+				return links_[idx];
+			}
+		}
+
+		constexpr void set_link(std::size_t idx, offset_type next) noexcept
+		{
+			if constexpr (inplace_links)
+			{
+				std::construct_at(std::addressof(storage_[idx].link), next);
+			}
+			else
+			{
+				links_[idx] = next;
+			}
+		}
+
+		// Finds the highest slot below before that holds a value, Capacity if there is none
+		[[nodiscard]] constexpr std::size_t previous_occupied_index(std::size_t before) const noexcept
+		{
+			while (before != 0)
+			{
+				const std::size_t w = (before - 1) / occupancy_word_bits;
+				occupancy_word bits = occupancy_[w];
+
+				if (const std::size_t count = before - w * occupancy_word_bits; count < occupancy_word_bits)
+					bits &= (occupancy_word{ 1 } << count) - 1;
+
+				if (bits != 0)
+					return w * occupancy_word_bits + (occupancy_word_bits - 1 - static_cast<std::size_t>(std::countl_zero(bits)));
+
+				before = w * occupancy_word_bits;
+			}
+
+			return Capacity;
+		}
+
+		// Finds the lowest slot at or after from that doesn't hold a value, offset_type_npos if there is none
+		[[nodiscard]] constexpr offset_type next_free_index(std::size_t from) const noexcept
+		{
+			if (from >= Capacity)
+				return offset_type_npos;
+
+			std::size_t w = from / occupancy_word_bits;
+			occupancy_word bits = ~occupancy_[w] & (~occupancy_word{} << (from % occupancy_word_bits));
+
+			while (bits == 0)
+			{
+				if (++w == occupancy_word_count)
+					return offset_type_npos;
+
+				bits = ~occupancy_[w];
+			}
+
+			// Bits past Capacity in the last word are never occupied
+			const std::size_t idx = w * occupancy_word_bits + static_cast<std::size_t>(std::countr_zero(bits));
+			return idx < Capacity ? static_cast<offset_type>(idx) : offset_type_npos;
+		}
+
+		// Invokes func with the index of every occupied slot, skipping a whole word of empty slots at once
+		// and stopping as soon as all size_ values were visited
+		template<class Func>
+		constexpr void for_each_occupied_index(Func&& func) const
+		{
+			std::size_t remaining = size_;
+			for (std::size_t w{}; remaining != 0; ++w)
+			{
+				occupancy_word bits = occupancy_[w];
+				const std::size_t base = w * occupancy_word_bits;
+				remaining -= static_cast<std::size_t>(std::popcount(bits));
+
+				if (bits == ~occupancy_word{})
+				{
+					for (std::size_t i = base; i < std::min(base + occupancy_word_bits, Capacity); ++i)
+						func(i);
+
+					continue;
+				}
+
+				for (; bits != 0; bits &= bits - 1)
+				{
+					func(base + static_cast<std::size_t>(std::countr_zero(bits)));
+				}
+			}
+		}
+
+		// Invokes func(base, matches) for occupancy words up to the last live value, matches has a bit set for every
+		// live value satisfying pred and may be zero. Stops as soon as func returns false.
+		template<class Pred, class Proj, class Func>
+		constexpr void scan_matches(Pred& pred, Proj& proj, Func&& func) const
+		{
+			std::size_t remaining = size_;
+			for (std::size_t w{}; remaining != 0; ++w)
+			{
+				const occupancy_word bits = occupancy_[w];
+				const std::size_t base = w * occupancy_word_bits;
+				const auto live = static_cast<std::size_t>(std::popcount(bits));
+				remaining -= live;
+
+				occupancy_word matches;
+				if constexpr (dense_scannable<Pred, Proj>)
+				{
+					// Free slots can't be read in constant evaluation
+					matches = live >= dense_scan_threshold && !std::is_constant_evaluated()
+						? dense_matches(base, bits, pred, proj)
+						: occupied_matches(base, bits, pred, proj);
+				}
+				else
+				{
+					matches = occupied_matches(base, bits, pred, proj);
+				}
+
+				if (!func(base, matches))
+					return;
+			}
+		}
+
+		// Tests only the occupied slots of an occupancy word, without branching on the result
+		template<class Pred, class Proj>
+		[[nodiscard]] constexpr occupancy_word occupied_matches(std::size_t base, occupancy_word bits, Pred& pred, Proj& proj) const
+		{
+			occupancy_word out{};
+			for (; bits != 0; bits &= bits - 1)
+			{
+				const auto i = static_cast<std::size_t>(std::countr_zero(bits));
+				out |= occupancy_word{ static_cast<bool>(std::invoke(pred, std::invoke(proj, *slot(base + i)))) } << i;
+			}
+
+			return out;
+		}
+
+		// Compares the field of every slot of an occupancy word below the high water mark against pred.value,
+		// bits of free slots are cleared before returning. Only bytes are read, no user code runs on free slots.
+		template<class Pred, class Proj>
+		[[nodiscard]] occupancy_word dense_matches(std::size_t base, occupancy_word bits, const Pred& pred, const Proj& proj) const noexcept
+		{
+			using field = std::remove_cv_t<decltype(Pred::value)>;
+
+			const std::size_t count = std::min(occupancy_word_bits, static_cast<std::size_t>(high_water_mark_) - base);
+
+			// Offset of the field within a slot, taken from a live value
+			const T* live = slot(base + static_cast<std::size_t>(std::countr_zero(bits)));
+			const std::ptrdiff_t offset = reinterpret_cast<const std::uint8_t*>(std::addressof(std::invoke(proj, *live))) - reinterpret_cast<const std::uint8_t*>(live);
+			const std::uint8_t* first = reinterpret_cast<const std::uint8_t*>(slot(base)) + offset;
+
+			if (slot_size == sizeof(field) && count == occupancy_word_bits)
+				return compare_fields(reinterpret_cast<const field*>(first), pred) & bits;
+
+			// Fields of strided slots and of partially used words are gathered first, slots past count aren't read.
+			// Constant trip count for full words so the gather unrolls
+			alignas(32) std::array<field, occupancy_word_bits> fields{};
+			if (count == occupancy_word_bits)
+				for (std::size_t i{}; i < occupancy_word_bits; ++i)
+					std::memcpy(std::addressof(fields[i]), first + i * slot_size, sizeof(field));
+			else
+				for (std::size_t i{}; i < count; ++i)
+					std::memcpy(std::addressof(fields[i]), first + i * slot_size, sizeof(field));
+
+			return compare_fields(std::data(fields), pred) & bits;
+		}
+
+		// Packs the mask returned by mask(i) for the Lanes fields starting at every i into one bit per field
+		template<std::size_t Lanes, class MaskFunc>
+		[[nodiscard]] static occupancy_word pack_lanes(MaskFunc&& mask) noexcept
+		{
+			occupancy_word out{};
+			for (std::size_t i{}; i < occupancy_word_bits; i += Lanes)
+				out |= (occupancy_word{ static_cast<std::uint32_t>(mask(i)) } & ((occupancy_word{ 1 } << Lanes) - 1)) << i;
+
+			return out;
+		}
+
+		// Compares occupancy_word_bits fields against pred.value, one vector compare and movemask per vector
+		// for float, double and signed 8, 32 and 64 bit integers, other fields are left to the vectorizer
+		template<class U, class Pred>
+		[[nodiscard]] static occupancy_word compare_fields(const U* fields, const Pred& pred) noexcept
+		{
+			using comparison = typename Pred::scan_comparison;
+			constexpr bool equal = std::is_same_v<comparison, std::equal_to<>>;
+			constexpr bool less = std::is_same_v<comparison, std::less<>>;
+
+			[[maybe_unused]] constexpr bool signed_integer = std::is_integral_v<U> && std::is_signed_v<U>;
+
+#if defined(__AVX2__)
+			if constexpr (std::is_same_v<U, float>)
+			{
+				constexpr int predicate = equal ? _CMP_EQ_OQ : less ? _CMP_LT_OQ : _CMP_GT_OQ;
+				const __m256 rhs = _mm256_set1_ps(pred.value);
+				return pack_lanes<8>([&](std::size_t i) { return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(fields + i), rhs, predicate)); });
+			}
+			else if constexpr (std::is_same_v<U, double>)
+			{
+				constexpr int predicate = equal ? _CMP_EQ_OQ : less ? _CMP_LT_OQ : _CMP_GT_OQ;
+				const __m256d rhs = _mm256_set1_pd(pred.value);
+				return pack_lanes<4>([&](std::size_t i) { return _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(fields + i), rhs, predicate)); });
+			}
+			else if constexpr (signed_integer && sizeof(U) == 1)
+			{
+				const __m256i rhs = _mm256_set1_epi8(static_cast<char>(pred.value));
+				return pack_lanes<32>([&](std::size_t i)
+				{
+					const __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fields + i));
+					return _mm256_movemask_epi8(equal ? _mm256_cmpeq_epi8(lhs, rhs) : less ? _mm256_cmpgt_epi8(rhs, lhs) : _mm256_cmpgt_epi8(lhs, rhs));
+				});
+			}
+			else if constexpr (signed_integer && sizeof(U) == 4)
+			{
+				const __m256i rhs = _mm256_set1_epi32(static_cast<int>(pred.value));
+				return pack_lanes<8>([&](std::size_t i)
+				{
+					const __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fields + i));
+					return _mm256_movemask_ps(_mm256_castsi256_ps(equal ? _mm256_cmpeq_epi32(lhs, rhs) : less ? _mm256_cmpgt_epi32(rhs, lhs) : _mm256_cmpgt_epi32(lhs, rhs)));
+				});
+			}
+			else if constexpr (signed_integer && sizeof(U) == 8)
+			{
+				const __m256i rhs = _mm256_set1_epi64x(static_cast<long long>(pred.value));
+				return pack_lanes<4>([&](std::size_t i)
+				{
+					const __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fields + i));
+					return _mm256_movemask_pd(_mm256_castsi256_pd(equal ? _mm256_cmpeq_epi64(lhs, rhs) : less ? _mm256_cmpgt_epi64(rhs, lhs) : _mm256_cmpgt_epi64(lhs, rhs)));
+				});
+			}
+			else
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+			if constexpr (std::is_same_v<U, float>)
+			{
+				const __m128 rhs = _mm_set1_ps(pred.value);
+				return pack_lanes<4>([&](std::size_t i)
+				{
+					const __m128 lhs = _mm_loadu_ps(fields + i);
+					return _mm_movemask_ps(equal ? _mm_cmpeq_ps(lhs, rhs) : less ? _mm_cmplt_ps(lhs, rhs) : _mm_cmpgt_ps(lhs, rhs));
+				});
+			}
+			else if constexpr (std::is_same_v<U, double>)
+			{
+				const __m128d rhs = _mm_set1_pd(pred.value);
+				return pack_lanes<2>([&](std::size_t i)
+				{
+					const __m128d lhs = _mm_loadu_pd(fields + i);
+					return _mm_movemask_pd(equal ? _mm_cmpeq_pd(lhs, rhs) : less ? _mm_cmplt_pd(lhs, rhs) : _mm_cmpgt_pd(lhs, rhs));
+				});
+			}
+			else if constexpr (signed_integer && sizeof(U) == 1)
+			{
+				const __m128i rhs = _mm_set1_epi8(static_cast<char>(pred.value));
+				return pack_lanes<16>([&](std::size_t i)
+				{
+					const __m128i lhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(fields + i));
+					return _mm_movemask_epi8(equal ? _mm_cmpeq_epi8(lhs, rhs) : less ? _mm_cmplt_epi8(lhs, rhs) : _mm_cmpgt_epi8(lhs, rhs));
+				});
+			}
+			else if constexpr (signed_integer && sizeof(U) == 4)
+			{
+				const __m128i rhs = _mm_set1_epi32(static_cast<int>(pred.value));
+				return pack_lanes<4>([&](std::size_t i)
+				{
+					const __m128i lhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(fields + i));
+					return _mm_movemask_ps(_mm_castsi128_ps(equal ? _mm_cmpeq_epi32(lhs, rhs) : less ? _mm_cmplt_epi32(lhs, rhs) : _mm_cmpgt_epi32(lhs, rhs)));
+				});
+			}
+			else
+#endif
+			{
+				occupancy_word out{};
+				for (std::size_t i{}; i < occupancy_word_bits; ++i)
+					out |= occupancy_word{ comparison{}(fields[i], pred.value) } << i;
+
+				return out;
+			}
+		}
+
+		// Slots are handed out in ascending order the first time, so only the slot at the mark can be new
+		constexpr void initialize_generation([[maybe_unused]] offset_type idx) noexcept
+		{
+			if constexpr (generational)
+			{
+				if (idx == generation_mark_)
+				{
+					generations_[idx] = Generation{};
+					generation_mark_ = static_cast<offset_type>(generation_mark_ + 1);
+				}
+			}
+		}
+
+		constexpr void advance_generation([[maybe_unused]] std::size_t idx) noexcept
+		{
+			if constexpr (generational)
+			{
+				generations_[idx] = static_cast<Generation>(generations_[idx] + 1u);
+			}
+		}
+
+		constexpr void destroy_all()
+		{
+			if constexpr (!std::is_trivially_destructible_v<T> || generational)
+			{
+				for_each_occupied_index([this](std::size_t i)
+				{
+					destroy_slot(i);
+					advance_generation(i);
+				});
+			}
+		}
+
+		// Copies the header and only the used prefix of the storage, links of erased slots are part of it
+		constexpr void initialize_bytewise(const inplace_free_list& other) noexcept
+		{
+			copy_header(other);
+			std::copy_n(std::data(other.storage_), high_water_mark_, std::data(storage_));
+
+			if constexpr (!inplace_links)
+			{
+				std::copy_n(std::data(other.links_), high_water_mark_, std::data(links_));
+			}
+		}
+
+		constexpr void initialize_copy(const inplace_free_list& other)
+		{
+			// Slots without a value can't be copied in constant evaluation
+			if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				if !consteval
+				{
+					initialize_bytewise(other);
+					return;
+				}
+			}
+
+			initialize_sparse(other, [&](T* ptr, std::size_t i) { std::construct_at(ptr, *other.slot(i)); });
+		}
+
+		template<class U, class Func>
+		constexpr void initialize_transform(const inplace_free_list<U, Capacity, AllocationPolicy, Generation, LayoutPolicy>& other, Func&& func)
+		{
+			initialize_sparse(other, [&](T* ptr, std::size_t i) { std::construct_at(ptr, func(*other.slot(i))); });
+		}
+
+		constexpr void initialize_move(inplace_free_list& other) noexcept
+		{
+			if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				if !consteval
+				{
+					initialize_bytewise(other);
+					return;
+				}
+			}
+
+			initialize_sparse(other, [&](T* ptr, std::size_t i) { std::construct_at(ptr, std::move(*other.slot(i))); });
+		}
+
+		// Constructs only the live values and rebuilds the free chain from the occupancy bitmap
+		// instead of following other's chain through its storage
+		template<class U, class Func>
+		constexpr void initialize_sparse(const inplace_free_list<U, Capacity, AllocationPolicy, Generation, LayoutPolicy>& other, Func&& construct)
+		{
+			initialize_slots();
+			copy_header(other);
+
+			if constexpr (!address_ordered)
+			{
+				rebuild_free_chain();
+			}
+
+			for_each_occupied_index([&](std::size_t i) { construct(slot(i), i); });
+		}
+
+		template<class U>
+		constexpr void copy_header(const inplace_free_list<U, Capacity, AllocationPolicy, Generation, LayoutPolicy>& other) noexcept
+		{
+			first_free_ = other.first_free_;
+			high_water_mark_ = other.high_water_mark_;
+			size_ = other.size_;
+			occupancy_ = other.occupancy_;
+
+			if constexpr (generational)
+			{
+				generation_mark_ = other.generation_mark_;
+				std::copy_n(std::data(other.generations_), generation_mark_, std::data(generations_));
+			}
+		}
+
+		// Links every free slot below the high water mark in ascending order
+		constexpr void rebuild_free_chain() noexcept
+		{
+			offset_type last = offset_type_npos;
+
+			for (std::size_t w{}; w * occupancy_word_bits < high_water_mark_; ++w)
+			{
+				occupancy_word bits = ~occupancy_[w];
+				if (const std::size_t remaining = high_water_mark_ - w * occupancy_word_bits; remaining < occupancy_word_bits)
+					bits &= (occupancy_word{ 1 } << remaining) - 1;
+
+				for (; bits != 0; bits &= bits - 1)
+				{
+					const auto idx = static_cast<offset_type>(w * occupancy_word_bits + static_cast<std::size_t>(std::countr_zero(bits)));
+
+					if (last == offset_type_npos)
+						first_free_ = idx;
+					else
+						set_link(last, idx);
+
+					last = idx;
+				}
+			}
+
+			if (last == offset_type_npos)
+				first_free_ = offset_type_npos;
+			else
+				set_link(last, offset_type_npos);
+		}
+
+		constexpr void initialize_empty() noexcept
+		{
+			initialize_slots();
+
+			size_ = {};
+			first_free_ = address_ordered ? offset_type{} : offset_type_npos;
+			high_water_mark_ = {};
+			occupancy_ = {};
+		}
+	};
+
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
 }
\ No newline at end of file
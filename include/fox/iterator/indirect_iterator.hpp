@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iterator>
+#include <type_traits>
 
 namespace fox::iterator
 {
@@ -15,8 +16,9 @@ namespace fox::iterator
 		using iterator_type = Iterator;
 		using value_type = std::iter_value_t<std::iter_value_t<Iterator>>;
 		using difference_type = std::iter_difference_t<Iterator>;
-		using pointer = value_type*;
-		using reference = value_type&;
+		// Pointers to const yield const references
+		using reference = std::iter_reference_t<std::iter_value_t<Iterator>>;
+		using pointer = std::add_pointer_t<std::remove_reference_t<reference>>;
 
 		using iterator_category =
 			std::conditional_t<
@@ -58,7 +60,10 @@ namespace fox::iterator
 		[[nodiscard]] constexpr pointer operator->() const
 			requires (std::is_pointer_v<Iterator> || requires (const Iterator i) { { *(i.operator->()) } -> std::convertible_to<pointer>; })
 		{
-			return *(current.operator->());
+			if constexpr (std::is_pointer_v<Iterator>)
+				return *current;
+			else
+				return *(current.operator->());
 		}
 
 		constexpr indirect_iterator& operator++()
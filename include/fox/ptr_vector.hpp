@@ -99,7 +99,25 @@ namespace fox
 			noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value || std::allocator_traits<Allocator>::is_always_equal::value)
 		{
 			_destroy_all();
-			storage_ = std::move(other.storage_);
+
+			if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value || std::allocator_traits<Allocator>::is_always_equal::value)
+			{
+				storage_ = std::move(other.storage_);
+			}
+			else if (this->get_allocator() == other.get_allocator())
+			{
+				storage_ = std::move(other.storage_);
+			}
+			else
+			{
+				// Objects allocated by other's allocator can't be freed with this one, they are moved into new allocations
+				storage_.clear();
+				storage_.reserve(std::size(other.storage_));
+
+				for (auto& e : other)
+					this->emplace_back(std::move(e));
+			}
+
 			return *this;
 		}
 
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <fox/free_list.hpp>
+
+#include <type_traits>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+
+namespace fox
+{
+	// Chunked free list shared by multiple threads, every thread allocates through its own magazine of slots
+	// reserved from the shared chunks. Magazines are refilled and flushed MagazineCapacity / 2 slots at a time
+	// under a lock, emplace and erase through a magazine take no lock otherwise.
+	// Every magazine has to be destroyed before the list, values still alive then are destroyed by the list.
+	template<class T, std::size_t ChunkCapacity, std::size_t MagazineCapacity = 64, class Allocator = std::allocator<T>>
+	class thread_caching_free_list
+	{
+		static_assert(MagazineCapacity >= 2, "thread_caching_free_list<T> magazine has to hold at least two slots.");
+
+		// Storage for one value, reserving a slot doesn't construct anything
+		struct slot
+		{
+			alignas(T) std::byte storage[sizeof(T)];
+
+			slot() noexcept {}
+		};
+
+		using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+
+		static constexpr std::size_t batch = MagazineCapacity / 2;
+
+		mutable std::mutex mutex_;
+		free_list<slot, ChunkCapacity, slot_allocator> shared_;
+		std::atomic<std::size_t> magazines_;
+
+	public:
+		using value_type = T;
+		using allocator_type = Allocator;
+		using reference = T&;
+		using const_reference = const T&;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		// Per thread cache of reserved slots, used by one thread at a time
+		class magazine
+		{
+			thread_caching_free_list* list_;
+			std::array<slot*, MagazineCapacity> slots_;
+			size_type size_ = 0;
+
+		public:
+			explicit magazine(thread_caching_free_list& list) noexcept
+				: list_(std::addressof(list))
+			{
+				list_->magazines_.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			magazine(const magazine&) = delete;
+			magazine(magazine&&) = delete;
+			magazine& operator=(const magazine&) = delete;
+			magazine& operator=(magazine&&) = delete;
+
+			// Reserved slots are returned to the list, a throwing lock terminates
+			~magazine() noexcept
+			{
+				flush();
+				list_->magazines_.fetch_sub(1, std::memory_order_relaxed);
+			}
+
+		public:
+			// Number of reserved slots held by this magazine
+			[[nodiscard]] size_type size() const noexcept
+			{
+				return size_;
+			}
+
+			[[nodiscard]] static constexpr size_type capacity() noexcept
+			{
+				return MagazineCapacity;
+			}
+
+		public:
+			template<class... Args>
+			[[nodiscard]] T* emplace(Args&&... args) requires (std::constructible_from<T, Args...>)
+			{
+				if (size_ == 0)
+					refill();
+
+				slot* s = slots_[size_ - 1];
+				T* out = std::construct_at(reinterpret_cast<T*>(s->storage), std::forward<Args>(args)...);
+				--size_;
+
+				return out;
+			}
+
+			[[nodiscard]] T* insert(const T& value) requires (std::is_copy_constructible_v<T>)
+			{
+				return emplace(value);
+			}
+
+			[[nodiscard]] T* insert(T&& value) requires (std::is_move_constructible_v<T>)
+			{
+				return emplace(std::forward<T&&>(value));
+			}
+
+			// ptr may have been emplaced through any magazine of the same list
+			void erase(const T* ptr)
+			{
+				// Flushed first, the value is left alive when taking the lock throws
+				if (size_ == MagazineCapacity)
+					flush_batch();
+
+				std::destroy_at(const_cast<T*>(ptr));
+				slots_[size_++] = reinterpret_cast<slot*>(const_cast<T*>(ptr));
+			}
+
+			// Returns every reserved slot to the shared chunks
+			void flush()
+			{
+				if (size_ == 0)
+					return;
+
+				std::scoped_lock lock(list_->mutex_);
+				list_->shared_.erase_n(std::span(std::data(slots_), size_));
+				size_ = 0;
+			}
+
+		private:
+			void refill()
+			{
+				std::scoped_lock lock(list_->mutex_);
+
+				const size_type before = list_->shared_.size();
+				try
+				{
+					(void)list_->shared_.emplace_n(batch, std::data(slots_));
+				}
+				catch (...)
+				{
+					// Slots reserved before the throw were already written
+					size_ = list_->shared_.size() - before;
+					std::rethrow_exception(std::current_exception());
+				}
+
+				size_ = batch;
+			}
+
+			// Returns the least recently cached half, the most recently freed slots are still warm in this thread's cache
+			void flush_batch()
+			{
+				{
+					std::scoped_lock lock(list_->mutex_);
+					list_->shared_.erase_n(std::span(std::data(slots_), batch));
+				}
+
+				std::move(std::data(slots_) + batch, std::data(slots_) + size_, std::data(slots_));
+				size_ -= batch;
+			}
+		};
+
+	public:
+		thread_caching_free_list()
+			: magazines_(0) {}
+
+		explicit thread_caching_free_list(const allocator_type& allocator)
+			: shared_(static_cast<slot_allocator>(allocator)), magazines_(0) {}
+
+		thread_caching_free_list(const thread_caching_free_list&) = delete;
+		thread_caching_free_list(thread_caching_free_list&&) = delete;
+		thread_caching_free_list& operator=(const thread_caching_free_list&) = delete;
+		thread_caching_free_list& operator=(thread_caching_free_list&&) = delete;
+
+		~thread_caching_free_list()
+		{
+			assert(magazines_.load(std::memory_order_relaxed) == 0 && "thread_caching_free_list<T> destroyed before its magazines.");
+
+			// With every magazine flushed each reserved slot holds a value
+			if constexpr (!std::is_trivially_destructible_v<T>)
+			{
+				for (slot& s : shared_)
+					std::destroy_at(reinterpret_cast<T*>(s.storage));
+			}
+		}
+
+	public:
+		[[nodiscard]] allocator_type get_allocator() const
+		{
+			return static_cast<allocator_type>(shared_.get_allocator());
+		}
+
+		[[nodiscard]] static constexpr size_type chunk_capacity() noexcept
+		{
+			return ChunkCapacity;
+		}
+
+		[[nodiscard]] static constexpr size_type magazine_capacity() noexcept
+		{
+			return MagazineCapacity;
+		}
+
+		// Slots holding a value or cached by a magazine
+		[[nodiscard]] size_type reserved() const
+		{
+			std::scoped_lock lock(mutex_);
+			return shared_.size();
+		}
+
+		[[nodiscard]] size_type capacity() const
+		{
+			std::scoped_lock lock(mutex_);
+			return shared_.capacity();
+		}
+
+		[[nodiscard]] bool owns(const T* ptr) const
+		{
+			std::scoped_lock lock(mutex_);
+			return shared_.owns(reinterpret_cast<const slot*>(ptr));
+		}
+	};
+}
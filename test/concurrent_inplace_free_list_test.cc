@@ -0,0 +1,110 @@
+#include <fox/concurrent_inplace_free_list.hpp>
+
+#include "ownership_stress.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+TEST(concurrent_inplace_free_list_test, default_constructor)
+{
+	fox::concurrent_inplace_free_list<std::int32_t, 64> v;
+
+	EXPECT_EQ(v.capacity(), 64);
+	EXPECT_EQ(v.size(), 0);
+	EXPECT_TRUE(v.empty());
+	EXPECT_FALSE(v.full());
+	EXPECT_TRUE(v.free_mask().all());
+}
+
+TEST(concurrent_inplace_free_list_test, emplace_erase)
+{
+	fox::concurrent_inplace_free_list<std::string, 64> v;
+
+	auto ptr = v.emplace("value");
+	ASSERT_NE(ptr, nullptr);
+	EXPECT_EQ(*ptr, "value");
+	EXPECT_TRUE(v.owns(ptr));
+	EXPECT_FALSE(v.free_mask().test(v.as_index(ptr)));
+	EXPECT_EQ(v.size(), 1);
+	EXPECT_FALSE(v.empty());
+
+	v.erase(ptr);
+	EXPECT_EQ(v.size(), 0);
+	EXPECT_TRUE(v.empty());
+	EXPECT_TRUE(v.free_mask().all());
+	EXPECT_EQ(v.emplace("other"), ptr);
+}
+
+TEST(concurrent_inplace_free_list_test, full)
+{
+	fox::concurrent_inplace_free_list<std::int32_t, 32> v;
+	std::set<std::int32_t*> pointers;
+
+	for (std::int32_t i{}; i < 32; ++i)
+	{
+		auto ptr = v.emplace(i);
+		ASSERT_NE(ptr, nullptr);
+		EXPECT_TRUE(pointers.insert(ptr).second);
+	}
+
+	EXPECT_EQ(v.emplace(0), nullptr);
+	EXPECT_TRUE(v.free_mask().none());
+	EXPECT_EQ(v.size(), 32);
+	EXPECT_TRUE(v.full());
+
+	v.erase(*pointers.begin());
+	EXPECT_EQ(v.size(), 31);
+	EXPECT_FALSE(v.full());
+	EXPECT_EQ(v.emplace(0), *pointers.begin());
+	EXPECT_TRUE(v.full());
+}
+
+TEST(concurrent_inplace_free_list_test, raii)
+{
+	auto u = std::make_shared<std::int32_t>(1);
+
+	{
+		fox::concurrent_inplace_free_list<std::shared_ptr<std::int32_t>, 16> v;
+
+		std::vector<std::shared_ptr<std::int32_t>*> pointers;
+		for (std::size_t i{}; i < 16; ++i)
+			pointers.push_back(v.emplace(u));
+
+		v.erase(pointers[3]);
+		v.erase(pointers[7]);
+
+		EXPECT_EQ(u.use_count(), 15);
+	}
+
+	EXPECT_EQ(u.use_count(), 1);
+}
+
+TEST(concurrent_inplace_free_list_test, multithreaded_stress)
+{
+	constexpr std::size_t capacity = 256;
+
+	using value = fox::test::stress_value;
+	fox::concurrent_inplace_free_list<value, capacity> v;
+
+	const std::size_t failures = fox::test::ownership_stress(8, 20000,
+		[]() { return 0; },
+		[&](int, const value& x) { return v.emplace(x); },
+		[&](int, value* ptr) { v.erase(ptr); });
+
+	EXPECT_EQ(failures, 0);
+
+	// Joining the threads synchronizes with every update, the count is exact again
+	EXPECT_EQ(v.size(), 0);
+	EXPECT_TRUE(v.free_mask().all());
+
+	// Every slot is still reachable exactly once
+	std::set<value*> pointers;
+	for (std::size_t i{}; i < capacity; ++i)
+		EXPECT_TRUE(pointers.insert(v.emplace(value{})).second);
+
+	EXPECT_EQ(v.emplace(value{}), nullptr);
+}
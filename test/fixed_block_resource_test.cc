@@ -0,0 +1,179 @@
+#include <fox/fixed_block_resource.hpp>
+
+#include <gtest/gtest.h>
+#include <random>
+#include <algorithm>
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	// Forwards to the default resource and counts what is still allocated through it
+	class counting_resource : public std::pmr::memory_resource
+	{
+	public:
+		std::size_t allocations = 0;
+		std::size_t bytes = 0;
+
+	protected:
+		void* do_allocate(std::size_t size, std::size_t alignment) override
+		{
+			++allocations;
+			bytes += size;
+			return std::pmr::new_delete_resource()->allocate(size, alignment);
+		}
+
+		void do_deallocate(void* ptr, std::size_t size, std::size_t alignment) override
+		{
+			--allocations;
+			bytes -= size;
+			std::pmr::new_delete_resource()->deallocate(ptr, size, alignment);
+		}
+
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == std::addressof(other);
+		}
+	};
+}
+
+TEST(fixed_block_resource_test, allocate_deallocate)
+{
+	counting_resource upstream;
+
+	{
+		fox::pmr::fixed_block_resource<24, 16> resource(&upstream);
+		static_assert(decltype(resource)::block_alignment() == 8);
+		EXPECT_EQ(resource.upstream_resource(), &upstream);
+
+		std::set<void*> blocks;
+		for (std::size_t i{}; i < 40; ++i)
+		{
+			void* ptr = resource.allocate(24, 8);
+			EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % 8, 0);
+			EXPECT_TRUE(blocks.insert(ptr).second);
+		}
+
+		// Smaller requests still take a whole block
+		void* small = resource.allocate(1, 1);
+		EXPECT_EQ(resource.statistics().size, 41);
+		EXPECT_EQ(resource.statistics().chunk_count, 3);
+
+		const std::size_t chunk_allocations = upstream.allocations;
+
+		resource.deallocate(small, 1, 1);
+		for (void* ptr : blocks)
+			resource.deallocate(ptr, 24, 8);
+
+		EXPECT_EQ(resource.statistics().size, 0);
+		EXPECT_LT(upstream.allocations, chunk_allocations);
+
+		EXPECT_TRUE(resource.is_equal(resource));
+		fox::pmr::fixed_block_resource<24, 16> other(&upstream);
+		EXPECT_FALSE(resource.is_equal(other));
+	}
+
+	EXPECT_EQ(upstream.allocations, 0);
+}
+
+TEST(fixed_block_resource_test, upstream_requests)
+{
+	counting_resource upstream;
+	fox::pmr::fixed_block_resource<32, 16> resource(&upstream);
+
+	// Larger or more aligned than a block
+	void* large = resource.allocate(33, 8);
+	void* aligned = resource.allocate(32, 64);
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0);
+
+	EXPECT_EQ(resource.statistics().size, 0);
+	EXPECT_EQ(upstream.allocations, 2);
+	EXPECT_EQ(upstream.bytes, 65);
+
+	resource.deallocate(large, 33, 8);
+	resource.deallocate(aligned, 32, 64);
+	EXPECT_EQ(upstream.allocations, 0);
+}
+
+TEST(fixed_block_resource_test, release)
+{
+	counting_resource upstream;
+	fox::pmr::fixed_block_resource<16, 8> resource(&upstream);
+
+	for (std::size_t i{}; i < 100; ++i)
+		(void)resource.allocate(16, 8);
+
+	EXPECT_NE(upstream.allocations, 0);
+
+	resource.release();
+	EXPECT_EQ(resource.statistics().size, 0);
+	EXPECT_EQ(resource.statistics().capacity, 0);
+	EXPECT_EQ(upstream.allocations, 0);
+
+	(void)resource.allocate(16, 8);
+	EXPECT_EQ(resource.statistics().size, 1);
+}
+
+template<class Resource>
+void node_containers(Resource& resource)
+{
+	std::mt19937 random_engine(7);
+
+	std::pmr::list<std::int32_t> list(&resource);
+	std::pmr::map<std::int32_t, std::int32_t> map(&resource);
+	std::pmr::unordered_map<std::int32_t, std::int32_t> unordered_map(&resource);
+
+	std::list<std::int32_t> expected_list;
+	std::map<std::int32_t, std::int32_t> expected_map;
+
+	for (std::int32_t i{}; i < 5000; ++i)
+	{
+		const auto key = static_cast<std::int32_t>(random_engine() % 1000);
+
+		if (random_engine() % 3 == 0 && !std::empty(list))
+		{
+			list.pop_front();
+			expected_list.pop_front();
+			map.erase(key);
+			unordered_map.erase(key);
+			expected_map.erase(key);
+		}
+		else
+		{
+			list.push_back(i);
+			expected_list.push_back(i);
+			map[key] = i;
+			unordered_map[key] = i;
+			expected_map[key] = i;
+		}
+	}
+
+	EXPECT_TRUE(std::ranges::equal(list, expected_list));
+	EXPECT_TRUE(std::ranges::equal(map, expected_map));
+	EXPECT_EQ(std::size(unordered_map), std::size(expected_map));
+	for (auto [key, value] : expected_map)
+		EXPECT_EQ(unordered_map.at(key), value);
+
+	EXPECT_NE(resource.statistics().size, 0);
+}
+
+TEST(fixed_block_resource_test, node_containers)
+{
+	counting_resource upstream;
+
+	{
+		// Large enough for the nodes of every container used, buckets are passed upstream
+		fox::pmr::fixed_block_resource<48, 64> resource(&upstream);
+		node_containers(resource);
+	}
+
+	{
+		fox::pmr::fixed_block_resource<48, 64, fox::aligned_chunk_lookup_policy> resource(&upstream);
+		node_containers(resource);
+	}
+
+	EXPECT_EQ(upstream.allocations, 0);
+}
@@ -1,21 +1,29 @@
 #include <fox/free_list.hpp>
+#include <fox/free_list_parallel.hpp>
 #include <gtest/gtest.h>
 
 #include <random>
 #include <memory>
 #include <algorithm>
+#include <atomic>
+#include <execution>
 #include <map>
+#include <memory_resource>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <vector>
 
 template<class T>
 class free_list_test;
 
-template<class T, std::size_t Capacity>
-class free_list_test<fox::free_list<T, Capacity>> : public testing::Test
+template<class T, std::size_t Capacity, class Allocator, class AllocationPolicy, class LayoutPolicy, class ChunkLookupPolicy, class IndexPolicy, class RemoteFreePolicy>
+class free_list_test<fox::free_list<T, Capacity, Allocator, AllocationPolicy, LayoutPolicy, ChunkLookupPolicy, IndexPolicy, RemoteFreePolicy>> : public testing::Test
 {
 public:
 	static inline thread_local std::mt19937 random_engine;
-	using free_list = fox::free_list<T, Capacity>;
+	using free_list = fox::free_list<T, Capacity, Allocator, AllocationPolicy, LayoutPolicy, ChunkLookupPolicy, IndexPolicy, RemoteFreePolicy>;
+	using index_type = typename free_list::index_type;
 
 	[[nodiscard]] T random_value()
 	{
@@ -33,7 +41,7 @@ public:
 		}
 	}
 
-	void insert_helper(std::map<std::size_t, T>& expected, free_list& actual)
+	void insert_helper(std::map<index_type, T>& expected, free_list& actual)
 	{
 		auto v = random_value();
 		auto ptr = actual.emplace(v);
@@ -44,7 +52,7 @@ public:
 		expected[actual.as_index(ptr)] = v;
 	}
 
-	void erase_helper(std::map<std::size_t, T>& expected, free_list& actual, const T* ptr)
+	void erase_helper(std::map<index_type, T>& expected, free_list& actual, const T* ptr)
 	{
 		auto idx = actual.as_index(ptr);
 		EXPECT_TRUE(expected.contains(idx));
@@ -52,7 +60,7 @@ public:
 		actual.erase(ptr);
 	}
 
-	void fill_random_diffuse(std::map<std::size_t, T>& expected, free_list& actual)
+	void fill_random_diffuse(std::map<index_type, T>& expected, free_list& actual)
 	{
 		while (std::size(expected) < 1000)
 		{
@@ -60,7 +68,7 @@ public:
 		}
 
 		// Pick random to delete
-		auto v = std::vector<std::pair<std::size_t, T>>(std::begin(expected), std::end(expected));
+		auto v = std::vector<std::pair<index_type, T>>(std::begin(expected), std::end(expected));
 		std::shuffle(std::begin(v), std::end(v), random_engine);
 
 		for (std::size_t i = {}; i < 1000 / 2; ++i)
@@ -69,7 +77,7 @@ public:
 		}
 	}
 
-	void fill_shared_ptr_diffuse(std::map<std::size_t, std::shared_ptr<T>>& expected, fox::free_list<std::shared_ptr<T>, Capacity>& actual, std::shared_ptr<T> value)
+	void fill_shared_ptr_diffuse(std::map<index_type, std::shared_ptr<T>>& expected, fox::free_list<std::shared_ptr<T>, Capacity, std::allocator<std::shared_ptr<T>>, AllocationPolicy, LayoutPolicy, ChunkLookupPolicy, IndexPolicy, RemoteFreePolicy>& actual, std::shared_ptr<T> value)
 	{
 		while (std::size(expected) < 1000)
 		{
@@ -82,7 +90,7 @@ public:
 		}
 
 		// Pick random to delete
-		auto v = std::vector<std::pair<std::size_t, std::shared_ptr<T>>>(std::begin(expected), std::end(expected));
+		auto v = std::vector<std::pair<index_type, std::shared_ptr<T>>>(std::begin(expected), std::end(expected));
 		std::shuffle(std::begin(v), std::end(v), random_engine);
 
 		for (std::size_t i = {}; i < 1000 / 2; ++i)
@@ -99,7 +107,14 @@ using free_list_test_types =
 ::testing::Types<
 	fox::free_list<std::int32_t, 32>,
 	fox::free_list<std::int32_t, 64>,
-	fox::free_list<std::string, 64>
+	fox::free_list<std::string, 64>,
+	fox::free_list<std::int32_t, 64, std::allocator<std::int32_t>, fox::address_ordered_allocation_policy>,
+	fox::free_list<std::string, 64, std::allocator<std::string>, fox::address_ordered_allocation_policy>,
+	fox::free_list<std::int32_t, 64, std::allocator<std::int32_t>, fox::lifo_allocation_policy, fox::cache_line_isolated_layout_policy>,
+	fox::free_list<std::int32_t, 64, std::allocator<std::int32_t>, fox::lifo_allocation_policy, fox::packed_layout_policy, fox::aligned_chunk_lookup_policy>,
+	fox::free_list<std::string, 64, std::allocator<std::string>, fox::address_ordered_allocation_policy, fox::packed_layout_policy, fox::aligned_chunk_lookup_policy>,
+	fox::free_list<std::int32_t, 64, std::allocator<std::int32_t>, fox::lifo_allocation_policy, fox::packed_layout_policy, fox::indexed_chunk_lookup_policy, fox::packed_index_policy<std::uint32_t>>,
+	fox::free_list<std::int32_t, 32, std::allocator<std::int32_t>, fox::lifo_allocation_policy, fox::packed_layout_policy, fox::indexed_chunk_lookup_policy, fox::packed_index_policy<std::uint64_t, 24>>
 >;
 
 TYPED_TEST_SUITE(free_list_test, free_list_test_types);
@@ -119,7 +134,7 @@ TYPED_TEST(free_list_test, copy_constructor)
 	using free_list = typename TestFixture::free_list;
 
 	free_list from;
-	std::map<std::size_t, typename free_list::value_type> expected;
+	std::map<typename free_list::index_type, typename free_list::value_type> expected;
 
 	TestFixture::fill_random_diffuse(expected, from);
 
@@ -139,7 +154,7 @@ TYPED_TEST(free_list_test, transform_constructor)
 	using free_list = typename TestFixture::free_list;
 
 	free_list from;
-	std::map<std::size_t, typename free_list::value_type> expected;
+	std::map<typename free_list::index_type, typename free_list::value_type> expected;
 
 	TestFixture::fill_random_diffuse(expected, from);
 
@@ -159,7 +174,7 @@ TYPED_TEST(free_list_test, move_constructor)
 	using free_list = typename TestFixture::free_list;
 
 	free_list from;
-	std::map<std::size_t, typename free_list::value_type> expected;
+	std::map<typename free_list::index_type, typename free_list::value_type> expected;
 
 	TestFixture::fill_random_diffuse(expected, from);
 
@@ -180,12 +195,12 @@ TYPED_TEST(free_list_test, copy_assignment_operator)
 	using free_list = typename TestFixture::free_list;
 
 	free_list from;
-	std::map<std::size_t, typename free_list::value_type> expected;
+	std::map<typename free_list::index_type, typename free_list::value_type> expected;
 
 	TestFixture::fill_random_diffuse(expected, from);
 
 	free_list to;
-	std::map<std::size_t, typename free_list::value_type> expected2;
+	std::map<typename free_list::index_type, typename free_list::value_type> expected2;
 	TestFixture::fill_random_diffuse(expected2, to);
 	to = from;
 
@@ -203,12 +218,12 @@ TYPED_TEST(free_list_test, move_assignment_operator)
 	using free_list = typename TestFixture::free_list;
 
 	free_list from;
-	std::map<std::size_t, typename free_list::value_type> expected;
+	std::map<typename free_list::index_type, typename free_list::value_type> expected;
 
 	TestFixture::fill_random_diffuse(expected, from);
 
 	free_list to;
-	std::map<std::size_t, typename free_list::value_type> expected2;
+	std::map<typename free_list::index_type, typename free_list::value_type> expected2;
 	TestFixture::fill_random_diffuse(expected2, to);
 	to = std::move(from);
 
@@ -241,7 +256,7 @@ TYPED_TEST(free_list_test, assign_range)
 	using free_list = typename TestFixture::free_list;
 
 	free_list from;
-	std::map<std::size_t, typename free_list::value_type> expected;
+	std::map<typename free_list::index_type, typename free_list::value_type> expected;
 
 	TestFixture::fill_random_diffuse(expected, from);
 
@@ -437,7 +452,7 @@ TYPED_TEST(free_list_test, emplace_erase_multiple)
 	using free_list = typename TestFixture::free_list;
 
 	free_list v;
-	std::map<std::size_t, typename free_list::value_type> expected;
+	std::map<typename free_list::index_type, typename free_list::value_type> expected;
 
 	for (std::size_t i = 0; i < 10; ++i)
 	{
@@ -454,13 +469,21 @@ TYPED_TEST(free_list_test, emplace_erase_multiple)
 TYPED_TEST(free_list_test, raii)
 {
 	using type = typename TestFixture::free_list::value_type;
-	using free_list = fox::free_list<std::shared_ptr<type>, TestFixture::free_list::chunk_capacity()>;
+	using free_list = fox::free_list<
+		std::shared_ptr<type>,
+		TestFixture::free_list::chunk_capacity(),
+		std::allocator<std::shared_ptr<type>>,
+		typename TestFixture::free_list::allocation_policy,
+		typename TestFixture::free_list::layout_policy,
+		typename TestFixture::free_list::chunk_lookup_policy,
+		typename TestFixture::free_list::index_policy
+	>;
 
 	std::shared_ptr<type> u = std::make_shared<type>(TestFixture::random_value());
 
 	{
 		free_list v;
-		std::map<std::size_t, typename free_list::value_type> expected;
+		std::map<typename free_list::index_type, typename free_list::value_type> expected;
 
 		for (std::size_t i = 0; i < 10; ++i)
 		{
@@ -477,4 +500,709 @@ TYPED_TEST(free_list_test, raii)
 	}
 
 	EXPECT_EQ(u.use_count(), 1);
-}
\ No newline at end of file
+}
+TYPED_TEST(free_list_test, emplace_n_erase_n)
+{
+	using free_list = typename TestFixture::free_list;
+
+	free_list v;
+	std::vector<typename free_list::pointer> pointers;
+
+	auto value = this->random_value();
+	v.emplace_n(v.chunk_capacity() * 3 + 5, std::back_inserter(pointers), value);
+
+	EXPECT_EQ(v.size(), v.chunk_capacity() * 3 + 5);
+	EXPECT_EQ(v.capacity(), v.chunk_capacity() * 4);
+
+	for (auto ptr : pointers)
+	{
+		EXPECT_TRUE(v.holds_value(ptr));
+		EXPECT_EQ(*ptr, value);
+	}
+
+	std::vector<typename free_list::pointer> first_chunk(std::begin(pointers), std::begin(pointers) + v.chunk_capacity());
+	v.erase_n(first_chunk);
+	EXPECT_EQ(v.size(), v.chunk_capacity() * 2 + 5);
+
+	std::vector<typename free_list::pointer> reused;
+	v.emplace_n(v.chunk_capacity(), std::back_inserter(reused), value);
+	std::ranges::sort(first_chunk);
+	std::ranges::sort(reused);
+	EXPECT_EQ(first_chunk, reused);
+
+	v.erase_n(pointers);
+	EXPECT_TRUE(v.empty());
+	EXPECT_EQ(v.capacity(), 0);
+}
+
+TYPED_TEST(free_list_test, snapshot_restore)
+{
+	using free_list = typename TestFixture::free_list;
+	using value_type = typename free_list::value_type;
+
+	if constexpr (!std::is_trivially_copyable_v<value_type>)
+	{
+		GTEST_SKIP() << "snapshot requires trivially copyable T";
+	}
+	else
+	{
+		free_list from;
+		std::map<typename free_list::index_type, value_type> expected;
+		TestFixture::fill_random_diffuse(expected, from);
+
+		std::vector<std::uint8_t> image;
+		from.snapshot(std::back_inserter(image));
+		EXPECT_EQ(std::size(image), from.snapshot_size());
+
+		free_list to;
+		(void)to.emplace(this->random_value());
+		EXPECT_EQ(to.restore(image), std::size(image));
+
+		EXPECT_EQ(to.size(), from.size());
+		EXPECT_EQ(to.capacity(), from.capacity());
+		for (const auto& e : expected)
+		{
+			EXPECT_TRUE(to.holds_value_at(e.first));
+			EXPECT_EQ(*to.at(e.first), e.second);
+		}
+
+		auto truncated = std::span(image).first(std::size(image) - 1);
+		EXPECT_THROW((void)to.restore(truncated), std::invalid_argument);
+		EXPECT_EQ(to.size(), from.size());
+	}
+}
+
+TEST(free_list_snapshot_test, rejects_inconsistent_chunk_images)
+{
+	// 16 byte list header followed by the first chunk: 80 byte header, then its occupancy word
+	constexpr std::size_t chunk_size_offset = 16 + 72;
+	constexpr std::size_t chunk_occupancy_offset = 16 + 80;
+
+	fox::free_list<std::int32_t, 32> from;
+	for (std::int32_t i{}; i < 4; ++i)
+		(void)from.emplace(i);
+
+	std::vector<std::uint8_t> image;
+	from.snapshot(std::back_inserter(image));
+
+	// Occupancy bit past the chunk's high water mark and capacity
+	image[chunk_occupancy_offset + 5] |= 0x01;
+	++image[chunk_size_offset];
+
+	fox::free_list<std::int32_t, 32> to;
+	(void)to.emplace(7);
+	EXPECT_THROW((void)to.restore(image), std::invalid_argument);
+	EXPECT_EQ(to.size(), 1);
+}
+
+TYPED_TEST(free_list_test, statistics)
+{
+	using free_list = typename TestFixture::free_list;
+
+	free_list v;
+	std::map<typename free_list::index_type, typename free_list::value_type> expected;
+	TestFixture::fill_random_diffuse(expected, v);
+
+	const auto stats = v.statistics();
+	EXPECT_EQ(stats.size, std::size(expected));
+	EXPECT_EQ(stats.capacity, v.capacity());
+	EXPECT_EQ(stats.chunk_count, static_cast<std::size_t>(std::distance(v.chunks_begin(), v.chunks_end())));
+
+	std::size_t chunk_sizes{};
+	for (auto it = v.chunks_begin(); it != v.chunks_end(); ++it)
+		chunk_sizes += it->size();
+
+	EXPECT_EQ(v.size(), chunk_sizes);
+
+	v.clear();
+	EXPECT_EQ(v.statistics().size, 0);
+	EXPECT_EQ(v.statistics().chunk_count, 0);
+}
+
+TYPED_TEST(free_list_test, optimize)
+{
+	using free_list = typename TestFixture::free_list;
+	using value_type = typename free_list::value_type;
+	using index_type = typename free_list::index_type;
+	constexpr std::size_t capacity = free_list::chunk_capacity();
+
+	free_list v;
+	v.set_empty_chunk_retention(3);
+
+	std::vector<value_type*> pointers;
+	for (std::size_t i{}; i < capacity * 10; ++i)
+		pointers.push_back(v.emplace(this->random_value()));
+
+	std::vector<value_type> values;
+	std::vector<index_type> indices;
+	for (auto ptr : pointers)
+	{
+		values.push_back(*ptr);
+		indices.push_back(v.as_index(ptr));
+	}
+
+	// Empties chunks 2, 8 and 9
+	for (std::size_t chunk : { 2, 8, 9 })
+		v.erase_n(std::span(pointers).subspan(chunk * capacity, capacity));
+
+	EXPECT_EQ(v.statistics().empty_chunk_count, 3);
+	EXPECT_EQ(v.capacity(), capacity * 10);
+
+	// Chunks 8 and 9 are freed, chunk 2 is kept since later chunks hold values
+	v.set_empty_chunk_retention(0);
+	v.optimize();
+
+	EXPECT_EQ(v.statistics().empty_chunk_count, 1);
+	EXPECT_EQ(v.capacity(), capacity * 8);
+	EXPECT_EQ(v.size(), capacity * 7);
+
+	// Indices taken before optimize still find their values
+	for (std::size_t i{}; i < std::size(pointers); ++i)
+	{
+		const std::size_t chunk = i / capacity;
+		if (chunk == 2 || chunk == 8 || chunk == 9)
+			continue;
+
+		EXPECT_TRUE(v.holds_value_at(indices[i]));
+		EXPECT_EQ(v.at(indices[i]), pointers[i]);
+		EXPECT_EQ(*v.at(indices[i]), values[i]);
+		EXPECT_EQ(v.as_index(pointers[i]), indices[i]);
+	}
+
+	// The kept chunk is filled before a new one is allocated
+	for (std::size_t i{}; i < capacity; ++i)
+		(void)v.emplace(this->random_value());
+
+	EXPECT_EQ(v.capacity(), capacity * 8);
+	EXPECT_EQ(v.statistics().empty_chunk_count, 0);
+
+	v.clear();
+	v.optimize();
+	EXPECT_EQ(v.capacity(), 0);
+}
+
+TYPED_TEST(free_list_test, empty_chunk_retention)
+{
+	using free_list = typename TestFixture::free_list;
+	using value_type = typename free_list::value_type;
+	constexpr std::size_t capacity = free_list::chunk_capacity();
+
+	free_list v;
+
+	std::vector<value_type*> pointers;
+	v.emplace_n(capacity, std::back_inserter(pointers), this->random_value());
+
+	// Without retention the chunk emptied at the back is freed right away
+	auto ptr = v.emplace(this->random_value());
+	EXPECT_EQ(v.capacity(), capacity * 2);
+	v.erase(ptr);
+	EXPECT_EQ(v.capacity(), capacity);
+
+	v.set_empty_chunk_retention(1);
+	for (std::size_t i{}; i < 10; ++i)
+	{
+		ptr = v.emplace(this->random_value());
+		EXPECT_EQ(v.capacity(), capacity * 2);
+		v.erase(ptr);
+		EXPECT_EQ(v.capacity(), capacity * 2);
+		EXPECT_EQ(v.statistics().empty_chunk_count, 1);
+	}
+
+	free_list copy = v;
+	EXPECT_EQ(copy.empty_chunk_retention(), 1);
+	EXPECT_EQ(copy.statistics().empty_chunk_count, 1);
+
+	v.erase_n(pointers);
+	EXPECT_TRUE(v.empty());
+	EXPECT_EQ(v.capacity(), capacity);
+	EXPECT_EQ(v.statistics().empty_chunk_count, 1);
+}
+
+TYPED_TEST(free_list_test, live_element_range)
+{
+	using free_list = typename TestFixture::free_list;
+	using value_type = typename free_list::value_type;
+	constexpr std::size_t capacity = free_list::chunk_capacity();
+
+	static_assert(std::ranges::forward_range<free_list>);
+	static_assert(std::ranges::forward_range<const free_list>);
+
+	free_list v;
+	EXPECT_EQ(std::begin(v), std::end(v));
+
+	std::vector<value_type*> pointers;
+	for (std::size_t i{}; i < capacity * 6; ++i)
+		pointers.push_back(v.emplace(this->random_value()));
+
+	// Empties chunks 0, 2 and 3, thins out the rest
+	for (std::size_t chunk : { 0, 2, 3 })
+		v.erase_n(std::span(pointers).subspan(chunk * capacity, capacity));
+
+	for (std::size_t i = 1; i < std::size(pointers); i += 3)
+	{
+		if (v.owns(pointers[i]) && v.holds_value(pointers[i]))
+			v.erase(pointers[i]);
+	}
+
+	std::multiset<value_type> expected;
+	std::vector<const value_type*> expected_order;
+	for (auto it = v.chunks_begin(); it != v.chunks_end(); ++it)
+	{
+		for (const auto& value : *it)
+		{
+			expected.insert(value);
+			expected_order.push_back(std::addressof(value));
+		}
+	}
+
+	std::vector<const value_type*> actual_order;
+	for (auto& value : v)
+		actual_order.push_back(std::addressof(value));
+
+	EXPECT_EQ(actual_order, expected_order);
+	EXPECT_EQ(static_cast<std::size_t>(std::ranges::distance(v)), v.size());
+
+	const free_list& cv = v;
+	EXPECT_EQ(std::multiset<value_type>(std::begin(cv), std::end(cv)), expected);
+
+	const value_type threshold = this->random_value();
+	const auto below = std::ranges::count_if(v, [&](const value_type& value) { return value < threshold; });
+	EXPECT_EQ(std::ranges::distance(v | std::views::filter([&](const value_type& value) { return value < threshold; })), below);
+
+	std::multiset<value_type> visited;
+	v.for_each_live([&](value_type& value) { visited.insert(value); });
+	EXPECT_EQ(visited, expected);
+}
+
+TYPED_TEST(free_list_test, parallel_for_each_transform_reduce)
+{
+	using free_list = typename TestFixture::free_list;
+	using value_type = typename free_list::value_type;
+
+	free_list v;
+	std::map<typename free_list::index_type, value_type> expected;
+	TestFixture::fill_random_diffuse(expected, v);
+
+	const auto to_size = [](const value_type& value) -> std::size_t
+	{
+		if constexpr (std::is_same_v<value_type, std::string>)
+			return std::size(value);
+		else
+			return static_cast<std::size_t>(value + 128);
+	};
+
+	std::size_t expected_sum = 7;
+	for (const auto& e : expected)
+		expected_sum += to_size(e.second);
+
+	EXPECT_EQ(fox::parallel_transform_reduce(std::execution::seq, v, std::size_t{ 7 }, std::plus<>{}, to_size), expected_sum);
+	EXPECT_EQ(fox::parallel_transform_reduce(std::execution::par, v, std::size_t{ 7 }, std::plus<>{}, to_size), expected_sum);
+
+	std::atomic<std::size_t> visited{};
+	fox::parallel_for_each(std::execution::par, v, [&](value_type& value)
+		{
+			value = value + value;
+			visited.fetch_add(1, std::memory_order_relaxed);
+		});
+
+	EXPECT_EQ(visited.load(), std::size(expected));
+	for (const auto& e : expected)
+		EXPECT_EQ(*v.at(e.first), e.second + e.second);
+
+	const free_list& cv = v;
+	std::atomic<std::size_t> const_visited{};
+	fox::parallel_for_each(std::execution::par, cv, [&](const value_type&) { const_visited.fetch_add(1, std::memory_order_relaxed); });
+	EXPECT_EQ(const_visited.load(), std::size(expected));
+
+	v.clear();
+	EXPECT_EQ(fox::parallel_transform_reduce(std::execution::par, v, std::size_t{ 7 }, std::plus<>{}, to_size), 7);
+}
+
+TEST(free_list_move_test, noexcept_follows_members)
+{
+	// The chunk index is a std::set, whose move constructor may allocate
+	static_assert(std::is_nothrow_move_constructible_v<fox::free_list<std::int32_t, 64>> == std::is_nothrow_move_constructible_v<std::set<const std::int32_t*>>);
+	static_assert(std::is_nothrow_move_assignable_v<fox::free_list<std::int32_t, 64>> == std::is_nothrow_move_assignable_v<std::set<const std::int32_t*>>);
+
+	// Unequal polymorphic allocators move assign element by element
+	static_assert(!std::is_nothrow_move_assignable_v<fox::pmr::free_list<std::int32_t, 64>>);
+
+	std::pmr::monotonic_buffer_resource resource;
+	fox::pmr::free_list<std::int32_t, 64> from(&resource);
+	const std::int32_t* value = from.emplace(5);
+
+	fox::pmr::free_list<std::int32_t, 64> to;
+	to = std::move(from);
+	EXPECT_EQ(to.size(), 1);
+	EXPECT_EQ(*to.at(0), 5);
+	EXPECT_NE(to.at(0), value);
+}
+
+TEST(free_list_chunk_selection_test, lowest_non_full_chunk)
+{
+	fox::free_list<std::int32_t, 4> v;
+
+	std::vector<std::int32_t*> values;
+	for (std::int32_t i{}; i < 5000 * 4; ++i)
+		values.push_back(v.emplace(i));
+
+	EXPECT_EQ(v.capacity(), 5000 * 4);
+
+	v.erase(values[4500 * 4 + 1]);
+	v.erase(values[10 * 4 + 2]);
+
+	auto copy = v;
+	EXPECT_EQ(copy.owning_chunk(copy.emplace(0)), std::addressof(*(copy.chunks_begin() + 10)));
+
+	EXPECT_EQ(v.emplace(0), values[10 * 4 + 2]);
+	EXPECT_EQ(v.emplace(0), values[4500 * 4 + 1]);
+	EXPECT_EQ(v.capacity(), 5000 * 4);
+
+	(void)v.emplace(0);
+	EXPECT_EQ(v.capacity(), 5001 * 4);
+
+	v.erase_n(std::span(values).subspan(4096 * 4, 4));
+	std::vector<std::int32_t*> refilled;
+	v.emplace_n(5, std::back_inserter(refilled), 0);
+
+	for (std::size_t i{}; i < 4; ++i)
+		EXPECT_EQ(v.owning_chunk(refilled[i]), std::addressof(*(v.chunks_begin() + 4096)));
+
+	EXPECT_EQ(v.owning_chunk(refilled[4]), std::addressof(*(v.chunks_begin() + 5000)));
+}
+
+TEST(free_list_chunk_lookup_test, pointer_to_chunk)
+{
+	fox::free_list<std::int32_t, 8> v;
+
+	std::vector<std::int32_t*> values;
+	for (std::int32_t i{}; i < 1000 * 8; ++i)
+		values.push_back(v.emplace(i));
+
+	std::mt19937 random_engine(7);
+	std::shuffle(std::begin(values), std::end(values), random_engine);
+
+	auto copy = v;
+	for (std::int32_t* ptr : values)
+	{
+		EXPECT_TRUE(v.owns(ptr));
+		EXPECT_FALSE(copy.owns(ptr));
+		EXPECT_EQ(v.at(v.as_index(ptr)), ptr);
+		EXPECT_TRUE(v.owning_chunk(ptr)->owns(ptr));
+		EXPECT_EQ(*copy.at(v.as_index(ptr)), *ptr);
+	}
+
+	// Chunks are read only, emplacing into one directly would bypass the list's counts
+	static_assert(std::is_same_v<decltype(v.owning_chunk(values[0])), const decltype(v)::chunk_type*>);
+	static_assert(std::is_same_v<decltype(*v.chunks_begin()), const decltype(v)::chunk_type&>);
+
+	const std::int32_t outside{};
+	EXPECT_FALSE(v.owns(&outside));
+
+	v.erase_n(std::span(values).first(4000));
+	for (std::int32_t* ptr : std::span(values).subspan(4000))
+	{
+		EXPECT_TRUE(v.holds_value(ptr));
+		EXPECT_EQ(v.at(v.as_index(ptr)), ptr);
+	}
+
+	v.clear();
+	EXPECT_FALSE(v.owns(&outside));
+}
+
+TEST(free_list_chunk_lookup_test, aligned_chunks)
+{
+	using free_list = fox::free_list<std::int32_t, 8, std::allocator<std::int32_t>, fox::lifo_allocation_policy, fox::packed_layout_policy, fox::aligned_chunk_lookup_policy>;
+	const std::size_t alignment = std::bit_ceil(sizeof(free_list::chunk_type));
+
+	free_list v;
+
+	std::vector<std::int32_t*> values;
+	v.emplace_n(1000 * 8, std::back_inserter(values), 0);
+
+	for (auto it = v.chunks_begin(); it != v.chunks_end(); ++it)
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(std::addressof(*it)) % alignment, 0);
+
+	auto copy = v;
+	for (std::size_t i{}; i < std::size(values); ++i)
+	{
+		EXPECT_EQ(v.owning_chunk(values[i]), std::addressof(*(v.chunks_begin() + static_cast<std::ptrdiff_t>(i / 8))));
+		EXPECT_EQ(copy.owning_chunk(copy.at(v.as_index(values[i]))), std::addressof(*(copy.chunks_begin() + static_cast<std::ptrdiff_t>(i / 8))));
+	}
+
+	std::mt19937 random_engine(11);
+	std::shuffle(std::begin(values), std::end(values), random_engine);
+
+	v.erase_n(std::span(values).first(4000));
+	for (std::int32_t* ptr : std::span(values).first(4000))
+		EXPECT_TRUE(!v.owns(ptr) || !v.holds_value(ptr));
+
+	for (std::int32_t* ptr : std::span(values).subspan(4000))
+	{
+		EXPECT_TRUE(v.holds_value(ptr));
+		EXPECT_EQ(v.at(v.as_index(ptr)), ptr);
+	}
+
+	const std::int32_t outside{};
+	EXPECT_FALSE(v.owns(&outside));
+}
+
+// Records the largest request made with every alignment
+class recording_resource : public std::pmr::memory_resource
+{
+public:
+	std::map<std::size_t, std::size_t> largest_request;
+
+private:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override
+	{
+		auto& largest = largest_request[alignment];
+		largest = std::max(largest, bytes);
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+	{
+		std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		return this == &other;
+	}
+};
+
+TEST(free_list_chunk_lookup_test, aligned_chunks_request_their_size)
+{
+	using free_list = fox::pmr::free_list<std::int64_t, 64, fox::lifo_allocation_policy, fox::packed_layout_policy, fox::aligned_chunk_lookup_policy>;
+	const std::size_t alignment = std::bit_ceil(sizeof(free_list::chunk_type) + sizeof(std::size_t));
+
+	recording_resource resource;
+	free_list v(&resource);
+
+	std::vector<std::int64_t*> values;
+	v.emplace_n(10 * 64, std::back_inserter(values), 0);
+
+	for (auto it = v.chunks_begin(); it != v.chunks_end(); ++it)
+		EXPECT_EQ(reinterpret_cast<std::uintptr_t>(std::addressof(*it)) % alignment, 0);
+
+	// The chunk isn't padded to its alignment
+	ASSERT_TRUE(resource.largest_request.contains(alignment));
+	EXPECT_LT(resource.largest_request[alignment], alignment * 3 / 4);
+
+	v.erase_n(values);
+	EXPECT_TRUE(v.empty());
+}
+
+template<class T>
+struct poisoning_allocator : std::allocator<T>
+{
+	using value_type = T;
+
+	poisoning_allocator() = default;
+
+	template<class U>
+	poisoning_allocator(const poisoning_allocator<U>&) noexcept {}
+
+	[[nodiscard]] T* allocate(std::size_t n)
+	{
+		T* out = std::allocator<T>::allocate(n);
+
+		// Volatile so the stores aren't dropped as dead before the chunk's construction
+		const auto bytes = reinterpret_cast<volatile std::uint8_t*>(out);
+		for (std::size_t i{}; i < n * sizeof(T); ++i)
+			bytes[i] = 0xAB;
+
+		return out;
+	}
+};
+
+template<class ChunkLookupPolicy, class RemoteFreePolicy = fox::local_free_policy>
+void expect_untouched_slots()
+{
+	using free_list = fox::free_list<std::int32_t, 1024, poisoning_allocator<std::int32_t>, fox::lifo_allocation_policy, fox::packed_layout_policy, ChunkLookupPolicy, fox::packed_index_policy<>, RemoteFreePolicy>;
+
+	free_list v;
+	(void)v.emplace(1);
+
+	// Slots above the first one were never handed out and keep the allocator's bytes
+	const auto bytes = reinterpret_cast<const std::uint8_t*>(v.chunks_begin()->data() + 1);
+	EXPECT_TRUE(std::all_of(bytes, bytes + 1023 * sizeof(std::int32_t), [](std::uint8_t b) { return b == 0xAB; }));
+
+	// Aligned chunks are placed within a larger request to allocators without an alignment parameter
+	std::vector<std::int32_t*> values;
+	v.emplace_n(4 * 1024, std::back_inserter(values), 2);
+	for (std::int32_t* ptr : values)
+		EXPECT_EQ(*v.at(v.as_index(ptr)), 2);
+
+	v.erase_n(values);
+	EXPECT_EQ(v.size(), 1);
+}
+
+TEST(free_list_chunk_lookup_test, new_chunks_leave_slots_untouched)
+{
+	expect_untouched_slots<fox::indexed_chunk_lookup_policy>();
+	expect_untouched_slots<fox::aligned_chunk_lookup_policy>();
+	expect_untouched_slots<fox::aligned_chunk_lookup_policy, fox::remote_free_policy>();
+}
+
+TEST(free_list_remote_free_test, collect_remote_frees)
+{
+	using free_list = fox::free_list<std::shared_ptr<std::int32_t>, 8, std::allocator<std::shared_ptr<std::int32_t>>, fox::lifo_allocation_policy, fox::packed_layout_policy, fox::aligned_chunk_lookup_policy, fox::packed_index_policy<>, fox::remote_free_policy>;
+	static_assert(!std::is_copy_constructible_v<free_list>);
+	static_assert(!std::is_constructible_v<free_list, const free_list&, std::identity>);
+
+	auto u = std::make_shared<std::int32_t>(1);
+	free_list v;
+
+	std::vector<std::shared_ptr<std::int32_t>*> values;
+	v.emplace_n(20, std::back_inserter(values), u);
+	EXPECT_EQ(u.use_count(), 21);
+
+	v.remote_erase(values[3]);
+	v.remote_erase(values[12]);
+	v.remote_erase(values[19]);
+
+	// Remotely erased values stay alive until collected
+	EXPECT_EQ(v.size(), 20);
+	EXPECT_EQ(u.use_count(), 21);
+	EXPECT_TRUE(v.holds_value(values[12]));
+
+	EXPECT_EQ(v.collect_remote_frees(), 3);
+	EXPECT_EQ(v.collect_remote_frees(), 0);
+	EXPECT_EQ(v.size(), 17);
+	EXPECT_EQ(u.use_count(), 18);
+	EXPECT_FALSE(v.holds_value(values[12]));
+
+	// The lowest non full chunk is reused
+	EXPECT_EQ(v.emplace(u), values[3]);
+
+	// emplace collects before allocating
+	v.remote_erase(values[3]);
+	for (std::size_t i = 16; i < 19; ++i)
+		v.remote_erase(values[i]);
+
+	EXPECT_EQ(v.size(), 18);
+	EXPECT_EQ(u.use_count(), 19);
+
+	(void)v.emplace(u);
+	EXPECT_EQ(v.size(), 15);
+	EXPECT_EQ(u.use_count(), 16);
+
+	// The emptied last chunk was freed
+	EXPECT_EQ(v.statistics().chunk_count, 2);
+
+	free_list moved = std::move(v);
+	moved.remote_erase(values[0]);
+	v = std::move(moved);
+	EXPECT_EQ(v.collect_remote_frees(), 1);
+	EXPECT_EQ(u.use_count(), 15);
+}
+
+TEST(free_list_remote_free_test, multithreaded_remote_erase)
+{
+	constexpr std::size_t consumer_count = 4;
+	constexpr std::size_t batch_count = 400;
+	constexpr std::size_t batch_size = 32;
+
+	struct value
+	{
+		std::size_t batch;
+		std::size_t sequence;
+	};
+
+	fox::free_list<value, 64, std::allocator<value>, fox::lifo_allocation_policy, fox::packed_layout_policy, fox::aligned_chunk_lookup_policy, fox::packed_index_policy<>, fox::remote_free_policy> v;
+
+	std::mutex mutex;
+	std::vector<std::vector<value*>> batches;
+	bool done = false;
+	std::vector<std::size_t> failures(consumer_count);
+
+	std::vector<std::thread> consumers;
+	for (std::size_t t{}; t < consumer_count; ++t)
+	{
+		consumers.emplace_back([&, t]()
+		{
+			for (;;)
+			{
+				std::vector<value*> batch;
+				{
+					std::scoped_lock lock(mutex);
+					if (std::empty(batches))
+					{
+						if (done)
+							return;
+
+						continue;
+					}
+
+					batch = std::move(batches.back());
+					batches.pop_back();
+				}
+
+				for (std::size_t i{}; i < std::size(batch); ++i)
+				{
+					// A slot handed out again before being collected would have been overwritten
+					if (batch[i]->batch != batch[0]->batch || batch[i]->sequence != i)
+						++failures[t];
+
+					v.remote_erase(batch[i]);
+				}
+			}
+		});
+	}
+
+	for (std::size_t b{}; b < batch_count; ++b)
+	{
+		std::vector<value*> batch;
+		for (std::size_t i{}; i < batch_size; ++i)
+			batch.push_back(v.emplace(value{ b, i }));
+
+		std::scoped_lock lock(mutex);
+		batches.push_back(std::move(batch));
+	}
+
+	{
+		std::scoped_lock lock(mutex);
+		done = true;
+	}
+
+	for (auto& t : consumers)
+		t.join();
+
+	for (auto f : failures)
+		EXPECT_EQ(f, 0);
+
+	(void)v.collect_remote_frees();
+	EXPECT_EQ(v.size(), 0);
+	EXPECT_TRUE(v.empty());
+}
+
+TEST(free_list_index_test, packed_index_policy)
+{
+	using compact = fox::free_list<std::int32_t, 1024, std::allocator<std::int32_t>, fox::lifo_allocation_policy, fox::packed_layout_policy, fox::indexed_chunk_lookup_policy, fox::packed_index_policy<std::uint32_t>>;
+	static_assert(std::is_same_v<compact::index_type, std::uint32_t>);
+	EXPECT_EQ(compact::max_chunk_count(), std::size_t{ 1 } << 22);
+
+	using wide = fox::free_list<std::int32_t, 1024, std::allocator<std::int32_t>, fox::lifo_allocation_policy, fox::packed_layout_policy, fox::indexed_chunk_lookup_policy, fox::packed_index_policy<std::uint64_t, 24>>;
+	EXPECT_EQ(wide::max_chunk_count(), std::size_t{ 1 } << 40);
+
+	// Two slot bits leave six bits for 64 chunks
+	using tiny = fox::free_list<std::int32_t, 4, std::allocator<std::int32_t>, fox::lifo_allocation_policy, fox::packed_layout_policy, fox::indexed_chunk_lookup_policy, fox::packed_index_policy<std::uint8_t>>;
+	EXPECT_EQ(tiny::max_chunk_count(), 64);
+
+	tiny v;
+	std::vector<std::int32_t*> values;
+	for (std::int32_t i{}; i < 64 * 4; ++i)
+		values.push_back(v.emplace(i));
+
+	for (std::int32_t* ptr : values)
+		EXPECT_EQ(v.at(v.as_index(ptr)), ptr);
+
+	EXPECT_EQ(v.as_index(values.back()), std::numeric_limits<std::uint8_t>::max());
+	EXPECT_THROW((void)v.emplace(0), std::length_error);
+	EXPECT_EQ(v.size(), 64 * 4);
+
+	v.erase(values[17]);
+	EXPECT_EQ(v.emplace(1), values[17]);
+}
@@ -5,17 +5,21 @@
 #include <memory>
 #include <algorithm>
 #include <map>
+#include <numeric>
+#include <cstring>
+#include <array>
 #include <vector>
+#include <ranges>
 
 template<class T>
 class inplace_free_list_test;
 
-template<class T, std::size_t Capacity>
-class inplace_free_list_test<fox::inplace_free_list<T, Capacity>> : public testing::Test
+template<class T, std::size_t Capacity, class AllocationPolicy, class LayoutPolicy>
+class inplace_free_list_test<fox::inplace_free_list<T, Capacity, AllocationPolicy, void, LayoutPolicy>> : public testing::Test
 {
 public:
 	static inline thread_local std::mt19937 random_engine;
-	using inplace_free_list = fox::inplace_free_list<T, Capacity>;
+	using inplace_free_list = fox::inplace_free_list<T, Capacity, AllocationPolicy, void, LayoutPolicy>;
 
 	[[nodiscard]] T random_value()
 	{
@@ -71,7 +75,7 @@ public:
 		}
 	}
 
-	void fill_shared_ptr_diffuse(std::map<std::size_t, std::shared_ptr<T>>& expected, fox::inplace_free_list<std::shared_ptr<T>, Capacity>& actual, std::shared_ptr<T> value)
+	void fill_shared_ptr_diffuse(std::map<std::size_t, std::shared_ptr<T>>& expected, fox::inplace_free_list<std::shared_ptr<T>, Capacity, AllocationPolicy, void, LayoutPolicy>& actual, std::shared_ptr<T> value)
 	{
 		std::uniform_int_distribution<std::int32_t> erase_dist(0, static_cast<std::int32_t>(actual.capacity()));
 
@@ -103,7 +107,12 @@ using inplace_free_list_test_types =
 ::testing::Types<
 	fox::inplace_free_list<std::int32_t, 32>,
 	fox::inplace_free_list<std::int32_t, 64>,
-	fox::inplace_free_list<std::string, 64>
+	fox::inplace_free_list<std::string, 64>,
+	fox::inplace_free_list<std::int32_t, 100, fox::address_ordered_allocation_policy>,
+	fox::inplace_free_list<std::string, 64, fox::address_ordered_allocation_policy>,
+	fox::inplace_free_list<std::int8_t, 1000>,
+	fox::inplace_free_list<std::int32_t, 64, fox::lifo_allocation_policy, void, fox::cache_line_isolated_layout_policy>,
+	fox::inplace_free_list<std::string, 64, fox::address_ordered_allocation_policy, void, fox::cache_line_isolated_layout_policy>
 >;
 
 TYPED_TEST_SUITE(inplace_free_list_test, inplace_free_list_test_types);
@@ -503,7 +512,13 @@ TYPED_TEST(inplace_free_list_test, emplace_erase_multiple)
 TYPED_TEST(inplace_free_list_test, raii)
 {
 	using type = typename TestFixture::inplace_free_list::value_type;
-	using inplace_free_list = fox::inplace_free_list<std::shared_ptr<type>, TestFixture::inplace_free_list::capacity()>;
+	using inplace_free_list = fox::inplace_free_list<
+		std::shared_ptr<type>,
+		TestFixture::inplace_free_list::capacity(),
+		typename TestFixture::inplace_free_list::allocation_policy,
+		void,
+		typename TestFixture::inplace_free_list::layout_policy
+	>;
 
 	std::shared_ptr<type> u = std::make_shared<type>(TestFixture::random_value());
 
@@ -526,4 +541,952 @@ TYPED_TEST(inplace_free_list_test, raii)
 	}
 
 	EXPECT_EQ(u.use_count(), 1);
-}
\ No newline at end of file
+}
+
+TYPED_TEST(inplace_free_list_test, holds_value_after_erase)
+{
+	using inplace_free_list = typename TestFixture::inplace_free_list;
+
+	inplace_free_list v;
+	std::map<std::size_t, typename inplace_free_list::value_type> expected;
+
+	TestFixture::fill_random_diffuse(expected, v);
+
+	auto free_mask = v.free_mask();
+	for (std::size_t i = 0; i < v.capacity(); ++i)
+	{
+		EXPECT_EQ(v.holds_value_at(i), expected.contains(i));
+		EXPECT_NE(v.holds_value_at(i), free_mask.test(i));
+	}
+
+	for (const auto& e : expected)
+	{
+		v.erase(v.at(e.first));
+		EXPECT_FALSE(v.holds_value_at(e.first));
+	}
+
+	EXPECT_TRUE(v.empty());
+	EXPECT_TRUE(v.free_mask().all());
+}
+
+
+TYPED_TEST(inplace_free_list_test, iterator)
+{
+	using inplace_free_list = typename TestFixture::inplace_free_list;
+
+	static_assert(std::forward_iterator<typename inplace_free_list::iterator>);
+	static_assert(std::forward_iterator<typename inplace_free_list::const_iterator>);
+	static_assert(std::ranges::forward_range<inplace_free_list>);
+
+	inplace_free_list v;
+	EXPECT_EQ(v.begin(), v.end());
+
+	std::map<std::size_t, typename inplace_free_list::value_type> expected;
+	TestFixture::fill_random_diffuse(expected, v);
+
+	auto e = std::begin(expected);
+	for (auto& value : v)
+	{
+		ASSERT_NE(e, std::end(expected));
+		EXPECT_EQ(v.as_index(std::addressof(value)), e->first);
+		EXPECT_EQ(value, e->second);
+		++e;
+	}
+
+	EXPECT_EQ(e, std::end(expected));
+
+	const inplace_free_list& cv = v;
+	EXPECT_EQ(static_cast<std::size_t>(std::ranges::distance(cv)), v.size());
+	EXPECT_EQ(typename inplace_free_list::const_iterator(v.begin()), cv.begin());
+}
+
+TYPED_TEST(inplace_free_list_test, for_each_live)
+{
+	using inplace_free_list = typename TestFixture::inplace_free_list;
+
+	inplace_free_list v;
+	std::map<std::size_t, typename inplace_free_list::value_type> expected;
+
+	std::size_t count{};
+	v.for_each_live([&](auto&) { ++count; });
+	EXPECT_EQ(count, 0);
+
+	// Fill completely to exercise dense words
+	while (!v.full())
+		TestFixture::insert_helper(expected, v);
+
+	v.for_each_live([&](auto& value) { EXPECT_EQ(value, expected[v.as_index(std::addressof(value))]); ++count; });
+	EXPECT_EQ(count, v.size());
+
+	TestFixture::fill_random_diffuse(expected, v);
+
+	count = 0;
+	std::as_const(v).for_each_live([&](const auto& value) { EXPECT_EQ(value, expected[v.as_index(std::addressof(value))]); ++count; });
+	EXPECT_EQ(count, std::size(expected));
+}
+
+TYPED_TEST(inplace_free_list_test, snapshot_restore)
+{
+	using inplace_free_list = typename TestFixture::inplace_free_list;
+	using value_type = typename inplace_free_list::value_type;
+
+	if constexpr (!std::is_trivially_copyable_v<value_type>)
+	{
+		GTEST_SKIP() << "snapshot requires trivially copyable T";
+	}
+	else
+	{
+		inplace_free_list from;
+		std::map<std::size_t, value_type> expected;
+		TestFixture::fill_random_diffuse(expected, from);
+
+		std::vector<std::uint8_t> image;
+		from.snapshot(std::back_inserter(image));
+		EXPECT_EQ(std::size(image), from.snapshot_size());
+
+		// Unaligned image followed by unrelated bytes
+		std::vector<std::uint8_t> buffer(1);
+		buffer.insert(std::end(buffer), std::begin(image), std::end(image));
+		buffer.push_back(0xFF);
+
+		inplace_free_list to;
+		EXPECT_EQ(to.restore(std::span(buffer).subspan(1)), std::size(image));
+
+		EXPECT_EQ(to.size(), from.size());
+		EXPECT_EQ(to.free_mask(), from.free_mask());
+		for (const auto& e : expected)
+			EXPECT_EQ(*to.at(e.first), e.second);
+
+		// Free slots are handed out in the same order
+		while (!from.full())
+		{
+			auto a = from.emplace(this->random_value());
+			auto b = to.emplace(*a);
+			EXPECT_EQ(from.as_index(a), to.as_index(b));
+		}
+
+		auto truncated = std::span(image).first(std::size(image) - 1);
+		EXPECT_THROW((void)to.restore(truncated), std::invalid_argument);
+		EXPECT_TRUE(to.full());
+
+		image[0] ^= 0xFF;
+		EXPECT_THROW((void)to.restore(image), std::invalid_argument);
+
+		inplace_free_list empty;
+		image.clear();
+		empty.snapshot(std::back_inserter(image));
+		EXPECT_EQ(to.restore(image), std::size(image));
+		EXPECT_TRUE(to.empty());
+		EXPECT_TRUE(to.free_mask().all());
+	}
+}
+
+TEST(inplace_free_list_snapshot_test, rejects_inconsistent_images)
+{
+	// Image offsets of a list of 32 int32_t without generations: 88 byte header, one occupancy word, then slots
+	constexpr std::size_t first_free_offset = 56;
+	constexpr std::size_t size_offset = 72;
+	constexpr std::size_t occupancy_offset = 88;
+	constexpr std::size_t storage_offset = 96;
+
+	using inplace_free_list = fox::inplace_free_list<std::int32_t, 32>;
+
+	inplace_free_list from;
+	std::array<std::int32_t*, 4> values;
+	for (std::int32_t i{}; i < 4; ++i)
+		values[static_cast<std::size_t>(i)] = from.emplace(i);
+
+	from.erase(values[1]);
+	from.erase(values[2]);
+
+	std::vector<std::uint8_t> image;
+	from.snapshot(std::back_inserter(image));
+
+	auto rejected = [&](auto&& forge)
+	{
+		auto forged = image;
+		forge(forged);
+
+		inplace_free_list to;
+		(void)to.emplace(7);
+		EXPECT_THROW((void)to.restore(forged), std::invalid_argument);
+		EXPECT_EQ(to.size(), 1);
+	};
+
+	auto set_occupied = [&](std::vector<std::uint8_t>& forged, std::size_t idx)
+	{
+		std::uint64_t occupancy;
+		std::memcpy(&occupancy, std::data(forged) + occupancy_offset, sizeof(occupancy));
+		occupancy |= std::uint64_t{ 1 } << idx;
+		std::memcpy(std::data(forged) + occupancy_offset, &occupancy, sizeof(occupancy));
+
+		std::uint64_t size;
+		std::memcpy(&size, std::data(forged) + size_offset, sizeof(size));
+		++size;
+		std::memcpy(std::data(forged) + size_offset, &size, sizeof(size));
+	};
+
+	// Values at or above the high water mark, including past the capacity
+	rejected([&](auto& forged) { set_occupied(forged, 40); });
+	rejected([&](auto& forged) { set_occupied(forged, 4); });
+
+	// Slot 2 heads the chain and links to slot 1
+	const std::size_t link_offset = storage_offset + 2 * sizeof(std::int32_t);
+	ASSERT_EQ(image[first_free_offset], 2);
+	ASSERT_EQ(image[link_offset], 1);
+
+	// Links past the high water mark, to a live slot, to itself or skipping a free slot
+	rejected([&](auto& forged) { forged[link_offset] = 200; });
+	rejected([&](auto& forged) { forged[link_offset] = 3; });
+	rejected([&](auto& forged) { forged[link_offset] = 2; });
+	rejected([&](auto& forged) { forged[link_offset] = 0xFF; });
+	rejected([&](auto& forged) { forged[first_free_offset] = 0; });
+
+	inplace_free_list to;
+	EXPECT_EQ(to.restore(image), std::size(image));
+	EXPECT_EQ(to.emplace(5), to.data() + 2);
+	EXPECT_EQ(to.emplace(6), to.data() + 1);
+	EXPECT_EQ(to.emplace(7), to.data() + 4);
+}
+
+TEST(inplace_free_list_snapshot_test, rejects_inconsistent_address_ordered_and_generation_images)
+{
+	// Image offsets of a list of 32 int32_t: 88 byte header, one occupancy word, then the generations
+	constexpr std::size_t first_free_offset = 56;
+	constexpr std::size_t generation_mark_offset = 80;
+	constexpr std::size_t generations_offset = 96;
+
+	using inplace_free_list = fox::inplace_free_list<std::int32_t, 32, fox::address_ordered_allocation_policy, std::uint8_t>;
+
+	inplace_free_list from;
+	std::array<std::int32_t*, 4> values;
+	for (std::int32_t i{}; i < 4; ++i)
+		values[static_cast<std::size_t>(i)] = from.emplace(i);
+
+	from.erase(values[1]);
+
+	std::vector<std::uint8_t> image;
+	from.snapshot(std::back_inserter(image));
+	ASSERT_EQ(image[first_free_offset], 1);
+
+	auto rejected = [&](std::size_t offset, std::uint8_t value)
+	{
+		auto forged = image;
+		forged[offset] = value;
+
+		inplace_free_list to;
+		EXPECT_THROW((void)to.restore(forged), std::invalid_argument);
+	};
+
+	// first_free has to be the lowest free slot
+	rejected(first_free_offset, 4);
+
+	// Odd generation on a free slot and even generation on a live one
+	rejected(generations_offset + 1, 1);
+	rejected(generations_offset + 3, 4);
+	rejected(generations_offset + 0, 2);
+
+	// Generations are written up to the mark, which can't be below the high water mark of 4 or past the capacity
+	ASSERT_EQ(image[generation_mark_offset], 4);
+	rejected(generation_mark_offset, 3);
+	rejected(generation_mark_offset, 33);
+
+	inplace_free_list to;
+	EXPECT_EQ(to.restore(image), std::size(image));
+	EXPECT_EQ(to.emplace(5), to.data() + 1);
+}
+
+TYPED_TEST(inplace_free_list_test, predicate_scan)
+{
+	using inplace_free_list = typename TestFixture::inplace_free_list;
+	using value_type = typename inplace_free_list::value_type;
+
+	inplace_free_list v;
+	std::map<std::size_t, value_type> expected;
+
+	const value_type threshold = this->random_value();
+	auto pred = [&](const value_type& value) { return value < threshold; };
+
+	EXPECT_EQ(v.find_if(pred), nullptr);
+	EXPECT_EQ(v.count_if(pred), 0);
+
+	auto check = [&]
+	{
+		auto match = std::ranges::find_if(expected, [&](const auto& e) { return pred(e.second); });
+		const value_type* first = match != std::end(expected) ? v.at(match->first) : nullptr;
+		EXPECT_EQ(v.find_if(pred), first);
+		EXPECT_EQ(std::as_const(v).find_if(pred), first);
+
+		const auto count = static_cast<std::size_t>(std::ranges::count_if(expected, [&](const auto& e) { return pred(e.second); }));
+		EXPECT_EQ(v.count_if(pred), count);
+
+		// Free slots are never passed to the predicate
+		std::size_t calls{};
+		(void)v.count_if([&](const value_type& value) { ++calls; return pred(value); });
+		EXPECT_EQ(calls, v.size());
+
+		std::size_t visited{};
+		v.for_each_live_if(pred, [&](value_type& value)
+		{
+			EXPECT_TRUE(pred(value));
+			EXPECT_EQ(value, expected[v.as_index(std::addressof(value))]);
+			++visited;
+		});
+		EXPECT_EQ(visited, count);
+
+		if constexpr (std::is_arithmetic_v<value_type>)
+		{
+			EXPECT_EQ(v.find_if(fox::less_than_value<value_type>{ threshold }), first);
+			EXPECT_EQ(v.count_if(fox::less_than_value<value_type>{ threshold }), count);
+			EXPECT_EQ(v.count_if(fox::equal_to_value<value_type>{ threshold }),
+				static_cast<std::size_t>(std::ranges::count_if(expected, [&](const auto& e) { return e.second == threshold; })));
+			EXPECT_EQ(v.count_if(fox::greater_than_value<value_type>{ threshold }),
+				static_cast<std::size_t>(std::ranges::count_if(expected, [&](const auto& e) { return e.second > threshold; })));
+		}
+	};
+
+	// Fill completely for full occupancy words, then erase half for partial ones
+	while (!v.full())
+		TestFixture::insert_helper(expected, v);
+
+	check();
+
+	TestFixture::fill_random_diffuse(expected, v);
+
+	check();
+}
+
+TEST(inplace_free_list_layout_test, cache_line_isolated)
+{
+	using inplace_free_list = fox::inplace_free_list<std::int32_t, 16, fox::lifo_allocation_policy, void, fox::cache_line_isolated_layout_policy>;
+	constexpr std::size_t cache_line_size = fox::cache_line_isolated_layout_policy::cache_line_size;
+
+	auto v = std::make_unique<inplace_free_list>();
+
+	std::vector<std::int32_t*> values;
+	while (!v->full())
+		values.push_back(v->emplace(static_cast<std::int32_t>(v->size())));
+
+	const auto header = reinterpret_cast<std::uintptr_t>(v.get());
+	for (std::size_t i{}; i < std::size(values); ++i)
+	{
+		const auto address = reinterpret_cast<std::uintptr_t>(values[i]);
+		EXPECT_EQ(address % cache_line_size, 0);
+		EXPECT_GE(address - header, cache_line_size);
+		EXPECT_EQ(v->as_index(values[i]), i);
+		EXPECT_EQ(v->at(i), values[i]);
+
+		if (i != 0)
+		{
+			EXPECT_EQ(address - reinterpret_cast<std::uintptr_t>(values[i - 1]), cache_line_size);
+		}
+	}
+
+	v->erase(values[5]);
+	EXPECT_EQ(v->emplace(5), values[5]);
+	EXPECT_EQ(v->count_if([](std::int32_t value) { return value < 8; }), 8);
+}
+
+TEST(inplace_free_list_projection_test, predicate_scan)
+{
+	struct order
+	{
+		std::int64_t id;
+		double price;
+	};
+
+	fox::inplace_free_list<order, 200> v;
+	std::vector<order*> orders;
+
+	for (std::int64_t i{}; i < 200; ++i)
+		orders.push_back(v.emplace(order{ i, static_cast<double>(i % 10) }));
+
+	for (std::size_t i{}; i < std::size(orders); i += 3)
+		v.erase(orders[i]);
+
+	auto above = [](double price) { return price > 6.5; };
+
+	EXPECT_EQ(v.find_if(above, &order::price), orders[7]);
+	EXPECT_EQ(v.count_if(above, &order::price), 40);
+	EXPECT_EQ(v.count_if([](std::int64_t id) { return id >= 150; }, &order::id), 33);
+
+	std::int64_t sum{};
+	std::as_const(v).for_each_live_if(above, [&](const order& o) { sum += o.id; }, &order::price);
+	EXPECT_EQ(sum, 4119);
+}
+
+TEST(inplace_free_list_projection_test, stateless_predicate_skips_free_slots)
+{
+	fox::inplace_free_list<std::int64_t, 200> v;
+	std::vector<std::int64_t*> values;
+
+	for (std::int64_t i{}; i < 200; ++i)
+		values.push_back(v.emplace(i));
+
+	for (std::size_t i{}; i < std::size(values); i += 7)
+		v.erase(values[i]);
+
+	static std::size_t calls;
+	auto even = [](std::int64_t value) { ++calls; return value % 2 == 0; };
+
+	calls = 0;
+	EXPECT_EQ(v.count_if(even), 85);
+	EXPECT_EQ(calls, v.size());
+
+	calls = 0;
+	std::int64_t sum{};
+	v.for_each_live_if(even, [&](std::int64_t value) { sum += value; });
+	EXPECT_EQ(sum, 8430);
+	EXPECT_EQ(calls, v.size());
+}
+
+TEST(inplace_free_list_projection_test, value_comparisons)
+{
+	struct order
+	{
+		std::int64_t id;
+		double price;
+		float weight;
+		std::int32_t quantity;
+		std::int8_t side;
+		std::uint16_t venue;
+	};
+
+	fox::inplace_free_list<order, 300> v;
+	std::vector<order*> orders;
+	std::vector<order> expected;
+
+	for (std::int64_t i{}; i < 300; ++i)
+		orders.push_back(v.emplace(order{ i, static_cast<double>(i % 10), static_cast<float>(i % 7) - 3.0f,
+			static_cast<std::int32_t>(i % 13) - 6, static_cast<std::int8_t>(i % 3 - 1), static_cast<std::uint16_t>(i % 5) }));
+
+	// Erased slots keep matching fields in their bytes, the last word is partially used
+	for (std::size_t i{}; i < std::size(orders); ++i)
+		if (i % 7 == 0)
+			v.erase(orders[i]);
+		else
+			expected.push_back(*orders[i]);
+
+	auto check = [&](auto pred, auto proj)
+	{
+		const auto count = static_cast<std::size_t>(std::ranges::count_if(expected, pred, proj));
+		EXPECT_EQ(v.count_if(pred, proj), count);
+
+		const auto match = std::ranges::find_if(expected, pred, proj);
+		EXPECT_EQ(v.find_if(pred, proj), match != std::end(expected) ? orders[static_cast<std::size_t>(match->id)] : nullptr);
+
+		std::size_t visited{};
+		v.for_each_live_if(pred, [&](const order& o) { EXPECT_TRUE(pred(std::invoke(proj, o))); ++visited; }, proj);
+		EXPECT_EQ(visited, count);
+	};
+
+	check(fox::greater_than_value<double>{ 6.5 }, &order::price);
+	check(fox::equal_to_value<double>{ 3.0 }, &order::price);
+	check(fox::less_than_value<float>{ -1.0f }, &order::weight);
+	check(fox::equal_to_value<std::int32_t>{ -6 }, &order::quantity);
+	check(fox::greater_than_value<std::int32_t>{ 2 }, &order::quantity);
+	check(fox::less_than_value<std::int8_t>{ 0 }, &order::side);
+	check(fox::greater_than_value<std::uint16_t>{ 2 }, &order::venue);
+	check(fox::less_than_value<std::int64_t>{ 150 }, &order::id);
+	check(fox::equal_to_value<std::int64_t>{ 1000 }, &order::id);
+
+	// Contiguous fields are compared in place
+	fox::inplace_free_list<std::int64_t, 200> ids;
+	std::vector<std::int64_t*> values;
+
+	for (std::int64_t i{}; i < 200; ++i)
+		values.push_back(ids.emplace(i % 50));
+
+	for (std::size_t i{}; i < std::size(values); i += 7)
+		ids.erase(values[i]);
+
+	EXPECT_EQ(ids.count_if(fox::less_than_value<std::int64_t>{ 10 }), 35);
+	EXPECT_EQ(ids.find_if(fox::equal_to_value<std::int64_t>{ 0 }), values[50]);
+	EXPECT_EQ(ids.count_if(fox::greater_than_value<std::int64_t>{ 44 }), 16);
+}
+
+TEST(inplace_free_list_projection_test, dereferencing_projection)
+{
+	struct node
+	{
+		const std::int32_t* value;
+	};
+
+	std::vector<std::int32_t> values(128);
+	std::iota(std::begin(values), std::end(values), 0);
+
+	fox::inplace_free_list<node, 128> v;
+	std::vector<node*> nodes;
+
+	for (const std::int32_t& value : values)
+		nodes.push_back(v.emplace(node{ std::addressof(value) }));
+
+	// Links written into erased slots overwrite their pointers
+	for (std::size_t i{}; i < std::size(nodes); i += 5)
+		v.erase(nodes[i]);
+
+	auto deref = [](const node& n) { return *n.value; };
+	EXPECT_EQ(v.count_if([](std::int32_t value) { return value >= 64; }, deref), 51);
+}
+
+TYPED_TEST(inplace_free_list_test, emplace_reuses_erased_slots)
+{
+	using inplace_free_list = typename TestFixture::inplace_free_list;
+
+	inplace_free_list v;
+
+	auto a = v.emplace(this->random_value());
+	auto b = v.emplace(this->random_value());
+	auto c = v.emplace(this->random_value());
+
+	EXPECT_EQ(v.as_index(a), 0);
+	EXPECT_EQ(v.as_index(b), 1);
+	EXPECT_EQ(v.as_index(c), 2);
+
+	v.erase(b);
+	EXPECT_EQ(v.emplace(this->random_value()), b);
+	EXPECT_EQ(v.as_index(v.emplace(this->random_value())), 3);
+
+	while (!v.full())
+		EXPECT_NE(v.emplace(this->random_value()), nullptr);
+
+	EXPECT_EQ(v.size(), v.capacity());
+	EXPECT_EQ(v.emplace(this->random_value()), nullptr);
+
+	v.clear();
+	EXPECT_FALSE(v.full());
+	EXPECT_EQ(v.as_index(v.emplace(this->random_value())), 0);
+}
+
+
+TYPED_TEST(inplace_free_list_test, allocation_order)
+{
+	using inplace_free_list = typename TestFixture::inplace_free_list;
+
+	inplace_free_list v;
+	std::vector<typename inplace_free_list::pointer> pointers;
+
+	while (!v.full())
+		pointers.push_back(v.emplace(this->random_value()));
+
+	v.erase(pointers[5]);
+	v.erase(pointers[1]);
+	v.erase(pointers[3]);
+
+	if constexpr (std::is_same_v<typename inplace_free_list::allocation_policy, fox::address_ordered_allocation_policy>)
+	{
+		EXPECT_EQ(v.emplace(this->random_value()), pointers[1]);
+		EXPECT_EQ(v.emplace(this->random_value()), pointers[3]);
+		EXPECT_EQ(v.emplace(this->random_value()), pointers[5]);
+	}
+	else
+	{
+		EXPECT_EQ(v.emplace(this->random_value()), pointers[3]);
+		EXPECT_EQ(v.emplace(this->random_value()), pointers[1]);
+		EXPECT_EQ(v.emplace(this->random_value()), pointers[5]);
+	}
+
+	EXPECT_TRUE(v.full());
+	EXPECT_EQ(v.emplace(this->random_value()), nullptr);
+}
+
+TYPED_TEST(inplace_free_list_test, handle)
+{
+	using base = typename TestFixture::inplace_free_list;
+	using inplace_free_list = fox::inplace_free_list<
+		typename base::value_type,
+		base::capacity(),
+		typename base::allocation_policy,
+		std::uint32_t,
+		typename base::layout_policy
+	>;
+
+	inplace_free_list v;
+
+	auto value = this->random_value();
+	auto handle = v.emplace_handle(value);
+	ASSERT_NE(v.try_get(handle), nullptr);
+	EXPECT_EQ(*v.try_get(handle), value);
+	EXPECT_TRUE(v.holds_value(handle));
+	EXPECT_EQ(v.get_handle(v.try_get(handle)), handle);
+
+	v.erase(handle);
+	EXPECT_FALSE(v.holds_value(handle));
+	EXPECT_EQ(v.try_get(handle), nullptr);
+
+	// Same slot is reused, old handle stays stale
+	auto reused = v.emplace_handle(value);
+	EXPECT_EQ(reused.index, handle.index);
+	EXPECT_NE(reused.generation, handle.generation);
+	EXPECT_EQ(v.try_get(handle), nullptr);
+	EXPECT_NE(v.try_get(reused), nullptr);
+
+	auto ptr = v.emplace(value);
+	auto ptr_handle = v.get_handle(ptr);
+	EXPECT_EQ(v.try_get(ptr_handle), ptr);
+	v.erase(ptr);
+	EXPECT_EQ(std::as_const(v).try_get(ptr_handle), nullptr);
+
+	v.clear();
+	EXPECT_EQ(v.try_get(reused), nullptr);
+
+	while (!v.full())
+		(void)v.emplace_handle(value);
+
+	auto none = v.emplace_handle(value);
+	EXPECT_EQ(v.try_get(none), nullptr);
+}
+
+TEST(inplace_free_list_handle_test, even_generation)
+{
+	using inplace_free_list = fox::inplace_free_list<std::int32_t, 8, fox::lifo_allocation_policy, std::uint32_t>;
+	using handle_type = inplace_free_list::handle_type;
+
+	inplace_free_list v;
+
+	// Value initialized handle matches the generation of a never used slot
+	EXPECT_FALSE(v.holds_value(handle_type{}));
+	EXPECT_EQ(v.try_get(handle_type{}), nullptr);
+	EXPECT_EQ(std::as_const(v).try_get(handle_type{}), nullptr);
+
+	auto handle = v.emplace_handle(1);
+	EXPECT_TRUE(v.holds_value(handle));
+	v.erase(handle);
+
+	// Handle carrying the even generation of the erased slot
+	const handle_type stale{ handle.index, handle.generation + 1 };
+	EXPECT_FALSE(v.holds_value(stale));
+	EXPECT_EQ(v.try_get(stale), nullptr);
+}
+
+TEST(inplace_free_list_handle_test, generations_initialized_on_first_use)
+{
+	using inplace_free_list = fox::inplace_free_list<std::int32_t, 1024, fox::lifo_allocation_policy, std::uint32_t>;
+	using handle_type = inplace_free_list::handle_type;
+
+	// Constructing over garbage doesn't write the generations, slots never handed out match no handle
+	alignas(inplace_free_list) std::array<std::uint8_t, sizeof(inplace_free_list)> buffer;
+	buffer.fill(0x01);
+
+	auto& v = *std::construct_at(reinterpret_cast<inplace_free_list*>(std::data(buffer)));
+	EXPECT_FALSE(v.holds_value(handle_type{ 5, 0x01010101 }));
+	EXPECT_EQ(v.snapshot_size(), inplace_free_list().snapshot_size());
+
+	const auto first = v.emplace_handle(1);
+	const auto second = v.emplace_handle(2);
+	EXPECT_EQ(first.generation, 1);
+	EXPECT_EQ(second.generation, 1);
+
+	// Generations survive clear, handles from before stay stale when the slots are reused
+	v.clear();
+
+	const auto reused = v.emplace_handle(3);
+	EXPECT_EQ(reused.index, first.index);
+	EXPECT_NE(reused.generation, first.generation);
+	EXPECT_FALSE(v.holds_value(first));
+	EXPECT_FALSE(v.holds_value(second));
+
+	const auto copy = v;
+	EXPECT_TRUE(copy.holds_value(reused));
+	EXPECT_FALSE(copy.holds_value(second));
+
+	std::destroy_at(std::addressof(v));
+}
+
+TYPED_TEST(inplace_free_list_test, handle_copy_move)
+{
+	using base = typename TestFixture::inplace_free_list;
+	using inplace_free_list = fox::inplace_free_list<
+		typename base::value_type,
+		base::capacity(),
+		typename base::allocation_policy,
+		std::uint16_t,
+		typename base::layout_policy
+	>;
+
+	inplace_free_list from;
+
+	auto value = this->random_value();
+	auto handle = from.emplace_handle(value);
+
+	inplace_free_list copy(from);
+	ASSERT_NE(copy.try_get(handle), nullptr);
+	EXPECT_EQ(*copy.try_get(handle), value);
+
+	inplace_free_list to(std::move(from));
+	ASSERT_NE(to.try_get(handle), nullptr);
+	EXPECT_EQ(*to.try_get(handle), value);
+	EXPECT_EQ(from.try_get(handle), nullptr);
+}
+
+TYPED_TEST(inplace_free_list_test, emplace_n_erase_n)
+{
+	using inplace_free_list = typename TestFixture::inplace_free_list;
+
+	inplace_free_list v;
+	std::vector<typename inplace_free_list::pointer> pointers;
+
+	auto value = this->random_value();
+	v.emplace_n(v.capacity() / 2, std::back_inserter(pointers), value);
+
+	EXPECT_EQ(v.size(), v.capacity() / 2);
+	EXPECT_EQ(std::size(pointers), v.capacity() / 2);
+
+	for (auto ptr : pointers)
+	{
+		EXPECT_TRUE(v.holds_value(ptr));
+		EXPECT_EQ(*ptr, value);
+	}
+
+	// Only the remaining capacity is emplaced
+	v.emplace_n(v.capacity(), std::back_inserter(pointers), value);
+	EXPECT_TRUE(v.full());
+	EXPECT_EQ(std::size(pointers), v.capacity());
+
+	std::vector<typename inplace_free_list::pointer> to_erase(std::begin(pointers), std::begin(pointers) + 10);
+	v.erase_n(to_erase);
+
+	EXPECT_EQ(v.size(), v.capacity() - 10);
+	for (auto ptr : to_erase)
+		EXPECT_FALSE(v.holds_value(ptr));
+
+	std::vector<typename inplace_free_list::pointer> reused;
+	v.emplace_n(10, std::back_inserter(reused), value);
+	std::ranges::sort(to_erase);
+	std::ranges::sort(reused);
+	EXPECT_EQ(to_erase, reused);
+
+	v.erase_n(pointers);
+	EXPECT_TRUE(v.empty());
+	EXPECT_TRUE(v.free_mask().all());
+}
+
+TEST(inplace_free_list_emplace_n_test, throwing_output)
+{
+	// Output iterator whose third write throws
+	struct throwing_output
+	{
+		using difference_type = std::ptrdiff_t;
+
+		std::vector<std::shared_ptr<int>*>* written;
+
+		throwing_output& operator*() { return *this; }
+		throwing_output& operator++() { return *this; }
+		throwing_output operator++(int) { return *this; }
+
+		throwing_output& operator=(std::shared_ptr<int>* ptr)
+		{
+			if (std::size(*written) == 2)
+				throw std::runtime_error("output is full");
+
+			written->push_back(ptr);
+			return *this;
+		}
+	};
+
+	const auto value = std::make_shared<int>(7);
+	std::vector<std::shared_ptr<int>*> written;
+
+	{
+		fox::inplace_free_list<std::shared_ptr<int>, 8, fox::lifo_allocation_policy, std::uint32_t> v;
+		EXPECT_THROW(v.emplace_n(5, throwing_output{ std::addressof(written) }, value), std::runtime_error);
+
+		// Value whose pointer couldn't be written is kept rather than leaked
+		EXPECT_EQ(std::size(written), 2);
+		EXPECT_EQ(v.size(), 3);
+		EXPECT_EQ(value.use_count(), 4);
+
+		for (auto& e : v)
+			EXPECT_TRUE(v.holds_value(v.get_handle(std::addressof(e))));
+	}
+
+	EXPECT_EQ(value.use_count(), 1);
+}
+
+TYPED_TEST(inplace_free_list_test, copy_preserves_free_slots)
+{
+	using inplace_free_list = typename TestFixture::inplace_free_list;
+
+	inplace_free_list from;
+	std::vector<typename inplace_free_list::pointer> pointers;
+
+	auto value = this->random_value();
+	from.emplace_n(10, std::back_inserter(pointers), value);
+	from.erase(pointers[2]);
+	from.erase(pointers[7]);
+
+	inplace_free_list to(from);
+	EXPECT_EQ(to.size(), 8);
+	EXPECT_EQ(to.free_mask(), from.free_mask());
+
+	// Erased slots are handed out before the never used ones
+	std::vector<std::size_t> reused;
+	for (std::size_t i = 0; i < 3; ++i)
+		reused.push_back(to.as_index(to.emplace(value)));
+
+	std::ranges::sort(reused);
+	EXPECT_EQ(reused, (std::vector<std::size_t>{ 2, 7, 10 }));
+
+	while (!to.full())
+		(void)to.emplace(value);
+
+	for (const auto& e : to)
+		EXPECT_EQ(e, value);
+}
+
+TYPED_TEST(inplace_free_list_test, transform_from_byte_sized)
+{
+	using inplace_free_list = typename TestFixture::inplace_free_list;
+	using byte_list = fox::inplace_free_list<std::int8_t, inplace_free_list::capacity(), typename inplace_free_list::allocation_policy, void, typename inplace_free_list::layout_policy>;
+
+	byte_list from;
+	while (!from.full())
+		(void)from.emplace(static_cast<std::int8_t>(from.size()));
+
+	from.erase(from.at(3));
+
+	inplace_free_list to(from, [this](std::int8_t) { return this->random_value(); });
+	EXPECT_EQ(to.size(), from.size());
+	EXPECT_FALSE(to.holds_value_at(3));
+	EXPECT_EQ(to.as_index(to.emplace(this->random_value())), 3);
+	EXPECT_TRUE(to.full());
+	EXPECT_EQ(to.emplace(this->random_value()), nullptr);
+}
+
+TEST(inplace_free_list_large_test, capacity_above_uint16)
+{
+	constexpr std::size_t capacity = 70000;
+	using inplace_free_list = fox::inplace_free_list<std::uint32_t, capacity>;
+
+	auto v = std::make_unique<inplace_free_list>();
+
+	for (std::uint32_t i = 0; i < capacity; ++i)
+		ASSERT_EQ(v->as_index(v->emplace(i)), i);
+
+	EXPECT_TRUE(v->full());
+	EXPECT_EQ(v->emplace(0u), nullptr);
+
+	v->erase(v->at(65535));
+	v->erase(v->at(69999));
+	EXPECT_FALSE(v->holds_value_at(65535));
+	EXPECT_EQ(v->as_index(v->emplace(1u)), 69999);
+	EXPECT_EQ(v->as_index(v->emplace(2u)), 65535);
+
+	auto copy = std::make_unique<inplace_free_list>(*v);
+	EXPECT_EQ(*copy->at(65535), 2u);
+	EXPECT_EQ(copy->size(), capacity);
+}
+
+TYPED_TEST(inplace_free_list_test, compact)
+{
+	using inplace_free_list = typename TestFixture::inplace_free_list;
+	using value_type = typename inplace_free_list::value_type;
+
+	inplace_free_list v;
+	std::map<std::size_t, value_type> expected;
+
+	TestFixture::fill_random_diffuse(expected, v);
+
+	std::map<value_type*, value_type> before;
+	for (const auto& e : expected)
+		before[v.at(e.first)] = e.second;
+
+	std::map<value_type*, value_type*> relocations;
+	v.compact([&](value_type* from, value_type* to)
+	{
+		EXPECT_FALSE(v.holds_value(from));
+		EXPECT_TRUE(v.holds_value(to));
+		EXPECT_LT(to, from);
+		relocations[from] = to;
+	});
+
+	EXPECT_EQ(v.size(), std::size(expected));
+
+	for (std::size_t i = 0; i < v.capacity(); ++i)
+		EXPECT_EQ(v.holds_value_at(i), i < v.size());
+
+	for (const auto& [ptr, value] : before)
+	{
+		auto r = relocations.find(ptr);
+		EXPECT_EQ(r != std::end(relocations) ? *r->second : *ptr, value);
+	}
+
+	// Free slots form a contiguous tail
+	const auto size = v.size();
+	while (!v.full())
+	{
+		value_type* ptr = v.emplace(this->random_value());
+		EXPECT_EQ(v.as_index(ptr), v.size() - 1);
+	}
+
+	EXPECT_EQ(v.size() - size, v.capacity() - size);
+
+	v.compact();
+	EXPECT_TRUE(v.full());
+}
+
+namespace
+{
+	template<class T, std::size_t Capacity, class AllocationPolicy>
+	constexpr std::size_t constant_evaluated_sum()
+	{
+		fox::inplace_free_list<T, Capacity, AllocationPolicy> v;
+		T* first = v.emplace(T(1));
+		T* second = v.emplace(T(2));
+		static_cast<void>(v.emplace(T(3)));
+
+		v.erase(second);
+		static_cast<void>(v.emplace(T(4)));
+
+		auto copy = v;
+		copy.erase(copy.at(v.as_index(first)));
+		copy.compact();
+
+		std::size_t sum{};
+		for (const T& value : copy)
+			sum += static_cast<std::size_t>(value);
+
+		return sum * 10 + v.count_if([](const T& value) { return value > T(1); });
+	}
+
+	constexpr auto constant_list = []
+	{
+		fox::inplace_free_list<std::int32_t, 8> v;
+		static_cast<void>(v.emplace(1));
+		v.erase(v.emplace(2));
+		static_cast<void>(v.emplace(3));
+		return v;
+	}();
+}
+
+TEST(inplace_free_list_constexpr_test, constant_evaluation)
+{
+	static_assert(constant_evaluated_sum<std::int32_t, 16, fox::lifo_allocation_policy>() == 72);
+	static_assert(constant_evaluated_sum<std::int32_t, 16, fox::address_ordered_allocation_policy>() == 72);
+	static_assert(constant_evaluated_sum<std::uint8_t, 300, fox::lifo_allocation_policy>() == 72);
+
+	static_assert([]
+	{
+		fox::inplace_free_list<std::string, 8> v;
+		v.erase(v.emplace("first"));
+		static_cast<void>(v.emplace("second"));
+		auto copy = v;
+		return copy.at(0)->size();
+	}() == 6);
+
+	static_assert([]
+	{
+		fox::inplace_free_list<std::int32_t, 8, fox::lifo_allocation_policy, std::uint32_t> v;
+		const auto first = v.emplace_handle(1);
+		v.clear();
+		const auto second = v.emplace_handle(2);
+		auto copy = v;
+		return !copy.holds_value(first) && copy.holds_value(second);
+	}());
+
+	static_assert(constant_list.size() == 2);
+	static_assert(*constant_list.at(0) == 1 && *constant_list.at(1) == 3);
+
+	EXPECT_EQ(constant_list.size(), 2);
+	EXPECT_EQ(*constant_list.at(1), 3);
+}
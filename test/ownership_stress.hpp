@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace fox::test
+{
+	struct stress_value
+	{
+		std::size_t owner;
+		std::size_t sequence;
+	};
+
+	// Every thread randomly emplaces and erases its own values, then erases whatever it still holds.
+	// make_context is called once on every thread, emplace(context, value) may return nullptr when the list is full.
+	// Returns the number of values found overwritten, a slot handed to two threads at once shows up here.
+	template<class MakeContext, class Emplace, class Erase>
+	[[nodiscard]] std::size_t ownership_stress(std::size_t thread_count, std::size_t iterations, MakeContext make_context, Emplace emplace, Erase erase)
+	{
+		std::vector<std::thread> threads;
+		std::vector<std::size_t> failures(thread_count);
+
+		for (std::size_t t{}; t < thread_count; ++t)
+		{
+			threads.emplace_back([&, t]()
+			{
+				auto context = make_context();
+				std::mt19937 random_engine(static_cast<std::uint32_t>(t));
+				std::vector<stress_value*> owned;
+
+				for (std::size_t i{}; i < iterations; ++i)
+				{
+					if (owned.empty() || random_engine() % 2 == 0)
+					{
+						if (auto ptr = emplace(context, stress_value{ t, i }); ptr != nullptr)
+							owned.push_back(ptr);
+					}
+					else
+					{
+						const std::size_t pick = random_engine() % owned.size();
+						stress_value* ptr = owned[pick];
+
+						if (ptr->owner != t)
+							++failures[t];
+
+						erase(context, ptr);
+						owned[pick] = owned.back();
+						owned.pop_back();
+					}
+				}
+
+				for (auto ptr : owned)
+				{
+					if (ptr->owner != t)
+						++failures[t];
+
+					erase(context, ptr);
+				}
+			});
+		}
+
+		for (auto& t : threads)
+			t.join();
+
+		std::size_t out{};
+		for (auto f : failures)
+			out += f;
+
+		return out;
+	}
+}
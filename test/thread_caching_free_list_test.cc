@@ -0,0 +1,170 @@
+#include <fox/thread_caching_free_list.hpp>
+
+#include "ownership_stress.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+TEST(thread_caching_free_list_test, emplace_erase)
+{
+	fox::thread_caching_free_list<std::string, 64, 8> v;
+
+	{
+		decltype(v)::magazine magazine(v);
+
+		auto ptr = magazine.emplace("value");
+		EXPECT_EQ(*ptr, "value");
+		EXPECT_TRUE(v.owns(ptr));
+
+		// The first emplace reserved half a magazine
+		EXPECT_EQ(magazine.size(), 3);
+		EXPECT_EQ(v.reserved(), 4);
+
+		magazine.erase(ptr);
+		EXPECT_EQ(magazine.size(), 4);
+		EXPECT_EQ(magazine.emplace("other"), ptr);
+		EXPECT_EQ(*ptr, "other");
+
+		magazine.erase(ptr);
+		magazine.flush();
+		EXPECT_EQ(magazine.size(), 0);
+		EXPECT_EQ(v.reserved(), 0);
+	}
+
+	EXPECT_EQ(v.capacity(), 0);
+}
+
+TEST(thread_caching_free_list_test, refill_flush_batches)
+{
+	fox::thread_caching_free_list<std::int32_t, 16, 8> v;
+	decltype(v)::magazine magazine(v);
+
+	std::set<std::int32_t*> pointers;
+	for (std::int32_t i{}; i < 40; ++i)
+		EXPECT_TRUE(pointers.insert(magazine.emplace(i)).second);
+
+	EXPECT_EQ(v.reserved(), 40);
+	EXPECT_EQ(magazine.size(), 0);
+
+	for (auto ptr : pointers)
+		magazine.erase(ptr);
+
+	// Full magazines return their older half
+	EXPECT_LE(magazine.size(), decltype(v)::magazine_capacity());
+	EXPECT_EQ(v.reserved(), magazine.size());
+
+	magazine.flush();
+	EXPECT_EQ(v.reserved(), 0);
+}
+
+TEST(thread_caching_free_list_test, erase_through_other_magazine)
+{
+	fox::thread_caching_free_list<std::int32_t, 16, 8> v;
+	decltype(v)::magazine producer(v);
+	decltype(v)::magazine consumer(v);
+
+	std::vector<std::int32_t*> pointers;
+	for (std::int32_t i{}; i < 20; ++i)
+		pointers.push_back(producer.emplace(i));
+
+	for (auto ptr : pointers)
+		consumer.erase(ptr);
+
+	EXPECT_EQ(v.reserved(), producer.size() + consumer.size());
+
+	// The consumer reuses slots cached from the producer's values without going back to the list
+	const std::set<std::int32_t*> emplaced(pointers.begin(), pointers.end());
+	const std::size_t reserved = v.reserved();
+	std::vector<std::int32_t*> reused;
+	while (consumer.size() != 0)
+	{
+		reused.push_back(consumer.emplace(0));
+		EXPECT_TRUE(emplaced.contains(reused.back()));
+	}
+
+	EXPECT_EQ(v.reserved(), reserved);
+
+	for (auto ptr : reused)
+		producer.erase(ptr);
+
+	producer.flush();
+	consumer.flush();
+	EXPECT_EQ(v.reserved(), 0);
+}
+
+TEST(thread_caching_free_list_test, flush_batch_boundary)
+{
+	fox::thread_caching_free_list<std::int32_t, 16, 8> v;
+	decltype(v)::magazine magazine(v);
+
+	std::vector<std::int32_t*> pointers;
+	for (std::int32_t i{}; i < 12; ++i)
+		pointers.push_back(magazine.emplace(i));
+
+	// Filling the magazine up to its capacity doesn't flush anything
+	for (std::size_t i{}; i < 8; ++i)
+		magazine.erase(pointers[i]);
+
+	EXPECT_EQ(magazine.size(), 8);
+	EXPECT_EQ(v.reserved(), 12);
+
+	// One past capacity returns the four least recently freed slots
+	magazine.erase(pointers[8]);
+	EXPECT_EQ(magazine.size(), 5);
+	EXPECT_EQ(v.reserved(), 8);
+
+	for (std::size_t i = 9; i-- > 4;)
+		EXPECT_EQ(magazine.emplace(0), pointers[i]);
+
+	EXPECT_EQ(magazine.size(), 0);
+	for (std::size_t i = 4; i < 12; ++i)
+		magazine.erase(pointers[i]);
+
+	magazine.flush();
+	EXPECT_EQ(v.reserved(), 0);
+}
+
+TEST(thread_caching_free_list_test, raii)
+{
+	auto u = std::make_shared<std::int32_t>(1);
+
+	{
+		fox::thread_caching_free_list<std::shared_ptr<std::int32_t>, 16, 4> v;
+
+		{
+			decltype(v)::magazine magazine(v);
+
+			std::vector<std::shared_ptr<std::int32_t>*> pointers;
+			for (std::size_t i{}; i < 40; ++i)
+				pointers.push_back(magazine.emplace(u));
+
+			magazine.erase(pointers[3]);
+			magazine.erase(pointers[7]);
+
+			EXPECT_EQ(u.use_count(), 39);
+		}
+
+		// Values left alive are destroyed with the list
+		EXPECT_EQ(u.use_count(), 39);
+	}
+
+	EXPECT_EQ(u.use_count(), 1);
+}
+
+TEST(thread_caching_free_list_test, multithreaded_stress)
+{
+	using value = fox::test::stress_value;
+	fox::thread_caching_free_list<value, 64, 16> v;
+
+	const std::size_t failures = fox::test::ownership_stress(8, 20000,
+		[&]() { return decltype(v)::magazine(v); },
+		[](auto& magazine, const value& x) { return magazine.emplace(x); },
+		[](auto& magazine, value* ptr) { magazine.erase(ptr); });
+
+	EXPECT_EQ(failures, 0);
+	EXPECT_EQ(v.reserved(), 0);
+}